@@ -7,6 +7,9 @@
 #include <string>
 #include <vector>
 
+#include "../../common/circle_cache_gl.h"
+#include "../../common/glyph_atlas.h"
+
 struct Vec2 {
     float x, y;
 };
@@ -241,32 +244,19 @@ void drawRect(float x, float y, float w, float h) {
     glEnd();
 }
 
+// Circles and rings are scaled from cached unit-circle tables, so no
+// cosf / sinf runs per frame (common/circle_cache.h)
 void drawCircle(float x, float y, float r, int seg = 48) {
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(x, y);
-    for (int i = 0; i <= seg; i++) {
-        float th = 2.0f * 3.1415926f * i / seg;
-        glVertex2f(x + cosf(th) * r, y + sinf(th) * r);
-    }
-    glEnd();
+    drawCachedCircle(x, y, r, seg);
 }
 
 void drawRing(float x, float y, float r, float t, int seg = 64) {
-    glBegin(GL_TRIANGLE_STRIP);
-    for (int i = 0; i <= seg; i++) {
-        float th = 2.0f * 3.1415926f * i / seg;
-        float cx = cosf(th), sy = sinf(th);
-        glVertex2f(x + (r - t) * cx, y + (r - t) * sy);
-        glVertex2f(x + r * cx, y + r * sy);
-    }
-    glEnd();
+    drawCachedRing(x, y, r - t, r, seg);
 }
 
 void drawText(float x, float y, const std::string& s,
               void* font = GLUT_BITMAP_HELVETICA_18) {
-    glRasterPos2f(x, y);
-    for (char c : s)
-        glutBitmapCharacter(font, c);
+    drawBitmapText(x, y, s, font);
 }
 
 void addParticles(Vec2 p, int n, float r, float g, float b) {
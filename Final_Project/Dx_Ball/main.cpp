@@ -22,6 +22,10 @@
 #include <GL/glut.h>
 #endif
 
+#include "../../common/circle_cache_gl.h"
+#include "../../common/glyph_atlas.h"
+#include "../../common/line_kernels.h"
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -63,31 +67,45 @@ static void playSFX(const char*, bool = false, float = 1.0f) {}
 static void playMusic(const char*) {}
 
 // --- Low-Level Drawing Primitives ---
+// Points emitted by the lab rasterizers are collected here and submitted with
+// a single glDrawArrays per flush instead of one glBegin/glEnd per pixel.
+struct PixelBatch {
+    std::vector<GLint> verts;     // x, y pairs
+    std::vector<GLubyte> colors;  // r, g, b triples, one per vertex
+    GLubyte r = 255, g = 255, b = 255;
+};
+static PixelBatch pixelBatch;
+
+static inline void lab_set_color(float r, float g, float b) {
+    pixelBatch.r = (GLubyte)iround(clampv(r, 0.f, 1.f) * 255.f);
+    pixelBatch.g = (GLubyte)iround(clampv(g, 0.f, 1.f) * 255.f);
+    pixelBatch.b = (GLubyte)iround(clampv(b, 0.f, 1.f) * 255.f);
+}
 static inline void lab_draw_pixel(int x, int y) {
-    glBegin(GL_POINTS);
-    glVertex2i(x, y);
-    glEnd();
+    pixelBatch.verts.push_back(x);
+    pixelBatch.verts.push_back(y);
+    pixelBatch.colors.push_back(pixelBatch.r);
+    pixelBatch.colors.push_back(pixelBatch.g);
+    pixelBatch.colors.push_back(pixelBatch.b);
+}
+static void lab_flush_pixels(float pointSize = 1.0f) {
+    if (pixelBatch.verts.empty())
+        return;
+    glPointSize(pointSize);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_INT, 0, pixelBatch.verts.data());
+    glColorPointer(3, GL_UNSIGNED_BYTE, 0, pixelBatch.colors.data());
+    glDrawArrays(GL_POINTS, 0, (GLsizei)(pixelBatch.verts.size() / 2));
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glPointSize(1.0f);
+    // clear() keeps the capacity, so steady-state frames do not reallocate
+    pixelBatch.verts.clear();
+    pixelBatch.colors.clear();
 }
 static void lab_draw_line(int x1, int y1, int x2, int y2) {
-    int dx = std::abs(x2 - x1), dy = std::abs(y2 - y1);
-    int sx = (x1 < x2) ? 1 : -1;
-    int sy = (y1 < y2) ? 1 : -1;
-    int err = dx - dy;
-    int x = x1, y = y1;
-    for (;;) {
-        lab_draw_pixel(x, y);
-        if (x == x2 && y == y2)
-            break;
-        int e2 = err << 1;
-        if (e2 > -dy) {
-            err -= dy;
-            x += sx;
-        }
-        if (e2 < dx) {
-            err += dx;
-            y += sy;
-        }
-    }
+    bresenhamLine(x1, y1, x2, y2, lab_draw_pixel);
 }
 static void lab_midpoint_circle(int cx, int cy, int r) {
     int x = 0, y = r;
@@ -215,20 +233,13 @@ static void drawRect(float cx, float cy, float w, float h) {
     glVertex2f(x0, y1);
     glEnd();
 }
+// Scaled from a cached unit circle, no trig per frame (common/circle_cache.h)
 static void drawCircleFilled(float cx, float cy, float r, int seg = 28) {
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(cx, cy);
-    for (int i = 0; i <= seg; i++) {
-        float th = (float)i * (float)(2.0 * M_PI) / seg;
-        glVertex2f(cx + cosf(th) * r, cy + sinf(th) * r);
-    }
-    glEnd();
+    drawCachedCircle(cx, cy, r, seg);
 }
 static void drawText(float x, float y, const std::string& s,
                      void* font = GLUT_BITMAP_HELVETICA_18) {
-    glRasterPos2f(x, y);
-    for (size_t i = 0; i < s.size(); ++i)
-        glutBitmapCharacter(font, s[i]);
+    drawBitmapText(x, y, s, font);
 }
 
 // --- Score/History Utilities ---
@@ -1107,9 +1118,9 @@ static void renderScene() {
                 continue;
             // Change outline color for indestructible bricks to emphasize them
             if (b.hp == 999)
-                glColor3f(0.8f, 0.8f, 0.8f);
+                lab_set_color(0.8f, 0.8f, 0.8f);
             else
-                glColor3f(0, 0, 0);
+                lab_set_color(0, 0, 0);
 
             int x0 = iround(b.x - b.w / 2.f), x1 = iround(b.x + b.w / 2.f);
             int y0 = iround(b.y - b.h / 2.f), y1 = iround(b.y + b.h / 2.f);
@@ -1118,6 +1129,7 @@ static void renderScene() {
             lab_draw_line(x1, y1, x0, y1);
             lab_draw_line(x0, y1, x0, y0);
         }
+        lab_flush_pixels(); // All outlines in one draw call
 
         // Paddle
         glColor3f(0.9f, 0.9f, 0.9f);
@@ -1137,11 +1149,10 @@ static void renderScene() {
         else
             glColor3f(1, 1, 1);
         drawCircleFilled(ball.pos.x, ball.pos.y, ball.radius, 24);
-        glPointSize(2.0f);
-        glColor3f(0, 0, 0);
+        lab_set_color(0, 0, 0);
         lab_midpoint_circle(iround(ball.pos.x), iround(ball.pos.y),
                             iround(ball.radius));
-        glPointSize(1.0f);
+        lab_flush_pixels(2.0f);
 
         // Perks
         for (size_t i = 0; i < perks.size(); ++i) {
@@ -1,55 +1,41 @@
 #include <iostream>
 #include <GL/glut.h>
+#include "../common/framebuffer_gl.h"
+#include "../common/image_io.h"
+#include "../common/stipple.h"
 using namespace std;
 
 int radius;
 int centerX, centerY;
 
-void plot(int x, int y, int count) {
-  if (count % 5 == 0) {
-    glBegin(GL_POINTS);
-    glVertex2i(x + centerX, y + centerY);
-    glEnd();
-  }
-}
+Framebuffer fb(640, 480);
+
+// One dot every 5 pixels of arc length, the same spacing in every octant
+StipplePattern dotted = {0x1, 5, 1.0f, 0.0f};
 
 void myInit(void) {
-  glClearColor(1.0, 1.0, 1.0, 0.0);
-  glColor3f(0.0f, 0.0f, 0.0f);
-  glPointSize(2.0);
   glMatrixMode(GL_PROJECTION);
   glLoadIdentity();
   gluOrtho2D(0.0, 640.0, 0.0, 480.0);
 }
 
+// Midpoint circle walked only over the "on" runs of the dot pattern, so the
+// cost is proportional to the dots drawn (see common/stipple.h)
 void midPointCircleAlgo(int r) {
-  int x = 0;
-  int y = r;
-  float decisionParameter = 1 - r;
-  int count = 0;
-  while (y >= x) {
-    plot(x, y, count);
-    plot(y, x, count);
-    plot(-x, y, count);
-    plot(-y, x, count);
-    plot(-x, -y, count);
-    plot(-y, -x, count);
-    plot(x, -y, count);
-    plot(y, -x, count);
-    if (decisionParameter < 0) {
-      x++;
-      decisionParameter += (x << 1) + 1;
-    } else {
-      x++, y--;
-      decisionParameter += ((x - y) << 1) + 1;
-    }
-    count++;
-  }
+  stippledCircleSpans(centerX, centerY, r, dotted,
+                      [](int y, int x0, int x1) { fb.putSpan(y, x0, x1); });
 }
 
-void myDisplay(void) {
-  glClear(GL_COLOR_BUFFER_BIT);
+void renderScene(void) {
+  fb.clear(packRGBA(255, 255, 255));
+  fb.setColor(0.0f, 0.0f, 0.0f);
+  fb.pointSize = 2;
   midPointCircleAlgo(radius);
+}
+
+void myDisplay(void) {
+  renderScene();
+  presentFramebuffer(fb);
   glFlush();
 }
 
@@ -59,6 +45,11 @@ int main(int argc, char** argv) {
   cout << "Enter the radius of the circle: ";
   cin >> radius;
 
+  if (const char* out = headlessPath(argc, argv)) {
+    renderScene();
+    return writePng(out, fb) ? 0 : 1;
+  }
+
   glutInit(&argc, argv);
   glutInitDisplayMode(GLUT_SINGLE | GLUT_RGB);
   glutInitWindowSize(800, 600);
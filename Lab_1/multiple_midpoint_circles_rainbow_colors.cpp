@@ -1,10 +1,16 @@
 #include <iostream>
 #include <GL/glut.h>
+#include "../common/framebuffer_gl.h"
+#include "../common/image_io.h"
+#include "../common/tile_raster.h"
 using namespace std;
 
 int noOfCir;
 int pntX1 = 400, pntY1 = 300;
 
+Framebuffer fb(800, 600);
+TileRasterizer raster;
+
 float colors[7][3] = {
     {1.0f, 0.0f, 0.0f},
     {1.0f, 0.5f, 0.0f},
@@ -15,57 +21,26 @@ float colors[7][3] = {
     {0.93f, 0.51f, 0.93f}
 };
 
-void setColor(int index) {
+uint32_t circleColor(int index) {
     int colorIndex = index % 7;
-    glColor3f(colors[colorIndex][0], colors[colorIndex][1], colors[colorIndex][2]);
-}
-
-void plot(int x, int y) {
-    glBegin(GL_POINTS);
-    glVertex2i(x + pntX1, y + pntY1);
-    glEnd();
+    return packRGBf(colors[colorIndex][0], colors[colorIndex][1], colors[colorIndex][2]);
 }
 
 void myInit(void) {
     glClearColor(1.0, 1.0, 1.0, 0.0);
-    glPointSize(5.0);
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
     gluOrtho2D(0.0, 800.0, 0.0, 600.0);
 }
 
+// Queues one midpoint circle; the pixels are written by renderScene() when
+// all circles are binned (see common/tile_raster.h)
 void midPointCircleAlgo(int r, int colorIndex) {
-    int x = 0;
-    int y = r;
-    float decision = 1.25 - r;
-
-    setColor(colorIndex);
-
-    plot(x, y);
-
-    while (y > x) {
-        if (decision < 0) {
-            x++;
-            decision += (x << 1) + 1;
-        } else {
-            x++, y--;
-            decision += ((x - y) << 1) + 1;
-        }
-
-        plot(x, y);
-        plot(x, -y);
-        plot(-x, y);
-        plot(-x, -y);
-        plot(y, x);
-        plot(-y, x);
-        plot(y, -x);
-        plot(-y, -x);
-    }
+    raster.circle(pntX1, pntY1, r, circleColor(colorIndex));
 }
 
-void myDisplay(void) {
-    glClear(GL_COLOR_BUFFER_BIT);
-    glPointSize(1.0);
+void renderScene(void) {
+    fb.clear(packRGBA(255, 255, 255));
 
     int radius = 30;
     for (int i = 0; i < noOfCir; i++) {
@@ -73,6 +48,12 @@ void myDisplay(void) {
         radius += 30;
     }
 
+    raster.flush(fb);
+}
+
+void myDisplay(void) {
+    renderScene();
+    presentFramebuffer(fb);
     glFlush();
 }
 
@@ -80,6 +61,11 @@ int main(int argc, char** argv) {
     cout << "Enter the number of circles you need: ";
     cin >> noOfCir;
 
+    if (const char* out = headlessPath(argc, argv)) {
+        renderScene();
+        return writePng(out, fb) ? 0 : 1;
+    }
+
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_SINGLE | GLUT_RGB);
     glutInitWindowSize(800, 600);
@@ -1,64 +1,47 @@
 #include<bits/stdc++.h>
 #include <GL/glut.h>
 #include <cmath>
+#include "../common/brush_line.h"
+#include "../common/framebuffer_gl.h"
+#include "../common/image_io.h"
+#include "../common/line_kernels.h"
 using namespace std;
 
 int x_start, y_start;
 int x_end, y_end;
 
-void putPixel(int x, int y) {
-    glBegin(GL_POINTS);
-    glVertex2i(x, y);
-    glEnd();
-}
+Framebuffer fb(500, 500);
+
+// 3x3 square brush = the pixel and its 8 neighbours
+BrushStroke boldBrush(1, BRUSH_SQUARE);
 
+// Each step only widens the covered run of the brush rows it touches; the
+// runs are filled once at the end, so no pixel is written twice.
 void drawBoldPixel(int x, int y) {
-    putPixel(x, y);
-    putPixel(x + 1, y);
-    putPixel(x - 1, y);
-    putPixel(x, y + 1);
-    putPixel(x, y - 1);
-    putPixel(x + 1, y + 1);
-    putPixel(x - 1, y - 1);
-    putPixel(x + 1, y - 1);
-    putPixel(x - 1, y + 1);
+    boldBrush.addPoint(x, y);
 }
 
 void drawLine8Neighbour(int x1, int y1, int x2, int y2) {
-    int dx = abs(x2 - x1);
-    int dy = abs(y2 - y1);
-    int sx = (x2 >= x1) ? 1 : -1;
-    int sy = (y2 >= y1) ? 1 : -1;
+    boldBrush.reset(min(y1, y2), max(y1, y2));
+    bresenhamLine(x1, y1, x2, y2, drawBoldPixel);
 
-    int err = dx - dy;
+    boldBrush.emitSpans([](int y, int xa, int xb) { fb.fillSpan(y, xa, xb); });
+}
 
-    while (true) {
-        drawBoldPixel(x1, y1);
-        if (x1 == x2 && y1 == y2) break;
-        int e2 = 2 * err;
-        if (e2 > -dy) {
-            err -= dy;
-            x1 += sx;
-        }
-        if (e2 < dx) {
-            err += dx;
-            y1 += sy;
-        }
-    }
+void renderScene() {
+    fb.clear(packRGBA(255, 255, 255));
+    fb.setColor(0.0, 1.0, 0.0);
+    drawLine8Neighbour(x_start, y_start, x_end, y_end);
 }
 
 void display() {
-    glClear(GL_COLOR_BUFFER_BIT);
-    glColor3f(0.0, 1.0, 0.0);
-    drawLine8Neighbour(x_start, y_start, x_end, y_end);
+    renderScene();
+    presentFramebuffer(fb);
     glFlush();
 }
 
 void init() {
-    glClearColor(1.0, 1.0, 1.0, 1.0);
-    glColor3f(0.0, 0.0, 0.0);
     gluOrtho2D(0, 500, 0, 500);
-    glPointSize(1.0);
 }
 
 int main(int argc, char** argv) {
@@ -70,6 +53,11 @@ int main(int argc, char** argv) {
     cout << "Enter End point (x2, y2): ";
     cin >> x_end >> y_end;
 
+    if (const char* out = headlessPath(argc, argv)) {
+        renderScene();
+        return writePng(out, fb) ? 0 : 1;
+    }
+
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_SINGLE | GLUT_RGB);
     glutInitWindowSize(500, 500);
@@ -1,5 +1,12 @@
 #include <GL/glut.h>
 #include <bits/stdc++.h>
+#include "../common/ccl.h"
+#include "../common/fill.h"
+#include "../common/fill_shader.h"
+#include "../common/framebuffer_gl.h"
+#include "../common/image_io.h"
+#include "../common/polygon_fill.h"
+#include "../common/ring.h"
 
 using namespace std;
 
@@ -8,18 +15,20 @@ using namespace std;
 float FILL_COLOR[3] = {1.0, 0.0, 1.0};
 float BACKGROUND_COLOR[3] = {1.0, 1.0, 1.0};
 
-bool visited[WINDOW_SIZE][WINDOW_SIZE];
+// The scene and all fills live here; display() only uploads it
+Framebuffer fb(WINDOW_SIZE, WINDOW_SIZE);
+int windowHeight = WINDOW_SIZE; // Mouse y is measured from the window top
 
-void getPixelColor(int x, int y, float color[3]) {
-    glReadPixels(x, y, 1, 1, GL_RGB, GL_FLOAT, color);
-}
+// The exam shapes. drawScene() outlines them, and the geometry fill mode
+// fills them straight from this description (see common/polygon_fill.h)
+const float SQUARE_X[4] = {180, 330, 330, 180};
+const float SQUARE_Y[4] = {400, 400, 250, 250};
+const float TRIANGLE_X[3] = {445, 370, 520};
+const float TRIANGLE_Y[3] = {400, 250, 250};
+const int CIRCLE_X = 380, CIRCLE_Y = 480, CIRCLE_R = 70;
 
-void setPixelColor(int x, int y, float color[3]) {
-    glColor3f(color[0], color[1], color[2]);
-    glBegin(GL_POINTS);
-        glVertex2i(x, y);
-    glEnd();
-    glFlush();
+void getPixelColor(int x, int y, float color[3]) {
+    unpackRGBf(fb.get(x, y), color);
 }
 
 int isSameColor(float c1[3], float c2[3]) {
@@ -30,48 +39,106 @@ int isSameColor(float c1[3], float c2[3]) {
     return 1;
 }
 
+SpanFill spanFill;
+
+// Fill styles besides the flat FILL_COLOR. Each one paints a whole run per
+// call (see common/fill_shader.h); the gradients span the scene's shapes.
+enum FillStyle { SOLID, PATTERN, LINEAR, RADIAL, HUE, STYLE_COUNT };
+const char* STYLE_NAMES[STYLE_COUNT] = {"solid", "pattern", "linear", "radial", "hue"};
+int fillStyle = SOLID;
+
+const char* PATTERN_ROWS[] = {"XX..", "XX..", "..XX", "..XX"};
+PatternShader patternFill = PatternShader::bitmap(PATTERN_ROWS, 4, packRGBA(255, 0, 255), packRGBA(255, 200, 255));
+LinearGradient linearFill(ColorRamp::between(packRGBA(255, 0, 255), packRGBA(0, 200, 255)), 180, 250, 520, 400);
+RadialGradient radialFill(ColorRamp::between(packRGBA(255, 255, 0), packRGBA(255, 0, 255)), 380, 480, 70);
+LinearGradient hueFill(ColorRamp::hueSweep(), 180, 0, 520, 0);
+
+void paintRun(int y, int xl, int xr) {
+    uint32_t* row = fb.row(y);
+    switch (fillStyle) {
+    case PATTERN: patternFill(row, y, xl, xr); break;
+    case LINEAR: linearFill(row, y, xl, xr); break;
+    case RADIAL: radialFill(row, y, xl, xr); break;
+    case HUE: hueFill(row, y, xl, xr); break;
+    default: std::fill(row + xl, row + xr + 1, fb.color); break;
+    }
+}
+
+// 4-neighbour fill of the oldColor region around (x, y), one horizontal run
+// at a time with an explicit stack of seed spans (see common/fill.h). The
+// result is uploaded with the rest of the framebuffer on the next redraw.
+// Any visited tracking the fill needs is a bitset sized from fb, so it
+// follows the window size.
 void floodFill4N(int x, int y, float fillColor[3], float oldColor[3]) {
-    if (x < 0 || x >= WINDOW_SIZE || y < 0 || y >= WINDOW_SIZE) {
+    if (!fb.inside(x, y)) {
         return;
     }
 
-    if (visited[x][y]) {
+    // Packed RGBA8 compares; span extension tests 4 pixels at a time
+    if (!colorNear(fb.get(x, y), packRGBf(oldColor[0], oldColor[1], oldColor[2]), spanFill.tolerance)) {
         return;
     }
 
-    float currentColor[3];
-    getPixelColor(x, y, currentColor);
-
-    if (!isSameColor(currentColor, oldColor)) {
-        return;
+    if (fillStyle == SOLID) {
+        spanFill.fill(fb, x, y, packRGBf(fillColor[0], fillColor[1], fillColor[2]));
+    } else {
+        spanFill.fill(fb, x, y, paintRun);
     }
+}
 
-    setPixelColor(x, y, fillColor);
-    visited[x][y] = true;
+// "Label all regions" mode: every region of the scene is labelled once,
+// using all cores, and a click then recolours the clicked region's
+// precomputed runs without any traversal (see common/ccl.h)
+RegionLabels regions;
+bool labelMode = false;
+
+void labelAllRegions() {
+    auto t0 = chrono::steady_clock::now();
+    regions.build(fb);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    cout << "Labelled " << regions.regionCount() << " regions in " << ms << " ms." << endl;
+}
 
-    floodFill4N(x + 1, y, fillColor, oldColor);
-    floodFill4N(x - 1, y, fillColor, oldColor);
-    floodFill4N(x, y + 1, fillColor, oldColor);
-    floodFill4N(x, y - 1, fillColor, oldColor);
+void fillRegion(int x, int y, float fillColor[3]) {
+    int label = regions.labelAt(x, y);
+    if (label < 0) {
+        return;
+    }
+    fb.setColor(fillColor[0], fillColor[1], fillColor[2]);
+    regions.forEachSpan(label, paintRun);
 }
 
+bool fillShapeAt(int x, int y, float fillColor[3]);
+bool geometryMode = false;
+
 void mouse(int button, int state, int x, int y) {
     if (button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) {
-        int click_y = WINDOW_SIZE - 1 - y;
+        int click_y = windowHeight - 1 - y;
+        if (!fb.inside(x, click_y)) {
+            return;
+        }
+
+        if (geometryMode) {
+            if (fillShapeAt(x, click_y, FILL_COLOR)) {
+                cout << "Filled the shape at (" << x << ", " << click_y << ") from its geometry." << endl;
+                glutPostRedisplay();
+            } else {
+                cout << "No shape at (" << x << ", " << click_y << ")." << endl;
+            }
+            return;
+        }
 
         float clickedColor[3];
         getPixelColor(x, click_y, clickedColor);
 
         if (isSameColor(clickedColor, BACKGROUND_COLOR)) {
-            cout << "Starting 4-Neighbor Flood Fill at (" << x << ", " << click_y << ")..." << endl;
-
-            for (int i = 0; i < WINDOW_SIZE; i++) {
-                for (int j = 0; j < WINDOW_SIZE; j++) {
-                    visited[i][j] = false;
-                }
+            if (labelMode) {
+                cout << "Filling labelled region at (" << x << ", " << click_y << ")..." << endl;
+                fillRegion(x, click_y, FILL_COLOR);
+            } else {
+                cout << "Starting 4-Neighbor Flood Fill at (" << x << ", " << click_y << ")..." << endl;
+                floodFill4N(x, click_y, FILL_COLOR, BACKGROUND_COLOR);
             }
-
-            floodFill4N(x, click_y, FILL_COLOR, BACKGROUND_COLOR);
             glutPostRedisplay();
         } else {
             cout << "Clicked on a colored pixel (Boundary). Fill not started." << endl;
@@ -79,8 +146,49 @@ void mouse(int button, int state, int x, int y) {
     }
 }
 
+void keyboard(unsigned char key, int, int) {
+    if (key == 'l' || key == 'L') {
+        labelMode = !labelMode;
+        if (labelMode) {
+            labelAllRegions();
+        } else {
+            cout << "Back to flood fill mode." << endl;
+        }
+    } else if (key == 'g' || key == 'G') {
+        geometryMode = !geometryMode;
+        cout << (geometryMode ? "Geometry fill mode." : "Back to flood fill mode.") << endl;
+    } else if (key == 's' || key == 'S') {
+        fillStyle = (fillStyle + 1) % STYLE_COUNT;
+        cout << "Fill style: " << STYLE_NAMES[fillStyle] << endl;
+    }
+}
+
+// The framebuffer is never smaller than WINDOW_SIZE, so shrinking the
+// window only changes how much of it is shown (one window pixel per
+// framebuffer pixel, from the bottom-left). It grows when the window
+// outgrows it; the shapes all lie inside WINDOW_SIZE, so the new area is
+// just background and the old contents (fills included) are kept.
+void reshape(int w, int h) {
+    int fw = max(fb.width, w), fh = max(fb.height, h);
+    if (fw != fb.width || fh != fb.height) {
+        Framebuffer old = fb;
+        fb.resize(fw, fh);
+        fb.clear(packRGBf(BACKGROUND_COLOR[0], BACKGROUND_COLOR[1], BACKGROUND_COLOR[2]));
+        for (int y = 0; y < old.height; y++) {
+            copy_n(old.row(y), old.width, fb.row(y));
+        }
+        if (labelMode) {
+            labelAllRegions();
+        }
+    }
+    windowHeight = max(h, 1);
+    glViewport(0, 0, w, h);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    gluOrtho2D(0.0, (double)max(w, 1), 0.0, (double)windowHeight);
+}
+
 void initOpenGL() {
-    glClearColor(BACKGROUND_COLOR[0], BACKGROUND_COLOR[1], BACKGROUND_COLOR[2], 0.0);
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
     gluOrtho2D(0.0, (double)WINDOW_SIZE, 0.0, (double)WINDOW_SIZE);
@@ -91,18 +199,17 @@ void drawCircleMidpoint(int cx, int cy, int r) {
     int y = r;
     int d = 1 - r;
 
-    glColor3f(0.0, 0.0, 1.0);
-    glBegin(GL_POINTS);
+    fb.setColor(0.0, 0.0, 1.0);
 
     while (x <= y) {
-        glVertex2i(cx + x, cy + y);
-        glVertex2i(cx + y, cy + x);
-        glVertex2i(cx - x, cy + y);
-        glVertex2i(cx - y, cy + x);
-        glVertex2i(cx + x, cy - y);
-        glVertex2i(cx + y, cy - x);
-        glVertex2i(cx - x, cy - y);
-        glVertex2i(cx - y, cy - x);
+        fb.putPixel(cx + x, cy + y);
+        fb.putPixel(cx + y, cy + x);
+        fb.putPixel(cx - x, cy + y);
+        fb.putPixel(cx - y, cy + x);
+        fb.putPixel(cx + x, cy - y);
+        fb.putPixel(cx + y, cy - x);
+        fb.putPixel(cx - x, cy - y);
+        fb.putPixel(cx - y, cy - x);
 
         if (d < 0) {
             d += 2 * x + 3;
@@ -112,34 +219,110 @@ void drawCircleMidpoint(int cx, int cy, int r) {
         }
         x++;
     }
+}
 
-    glEnd();
+void drawPolygonOutline(const float* xs, const float* ys, int n) {
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1) % n;
+        fb.drawLine((int)xs[i], (int)ys[i], (int)xs[j], (int)ys[j]);
+    }
 }
 
-void display() {
-    glClear(GL_COLOR_BUFFER_BIT);
+// Draws the shapes once; fills are applied on top and persist across redraws
+void drawScene() {
+    fb.clear(packRGBf(BACKGROUND_COLOR[0], BACKGROUND_COLOR[1], BACKGROUND_COLOR[2]));
+
+    fb.setColor(1.0, 0.0, 0.0);
+    drawPolygonOutline(SQUARE_X, SQUARE_Y, 4);
 
-    glColor3f(1.0, 0.0, 0.0);
-    glBegin(GL_LINE_LOOP);
-        glVertex2i(180, 400);
-        glVertex2i(330, 400);
-        glVertex2i(330, 250);
-        glVertex2i(180, 250);
-    glEnd();
+    fb.setColor(0.0, 1.0, 0.0);
+    drawPolygonOutline(TRIANGLE_X, TRIANGLE_Y, 3);
 
-    glColor3f(0.0, 1.0, 0.0);
-    glBegin(GL_LINE_LOOP);
-        glVertex2i(445, 400);
-        glVertex2i(370, 250);
-        glVertex2i(520, 250);
-    glEnd();
+    drawCircleMidpoint(CIRCLE_X, CIRCLE_Y, CIRCLE_R);
+}
 
-    drawCircleMidpoint(380, 480, 70);
+// Geometry fill mode: the clicked shape is found with a point-in-shape test
+// and filled with scanline spans from its vertex list or centre/radius, so
+// no pixel is read back. The outline is drawn again on top of the fill.
+PolygonFiller polygonFiller;
+RingFiller ringFiller;
 
+// paintRun clipped to the framebuffer, which may be smaller than the shapes
+void paintClipped(int y, int xl, int xr) {
+    if (y < 0 || y >= fb.height) {
+        return;
+    }
+    xl = max(xl, 0);
+    xr = min(xr, fb.width - 1);
+    if (xl <= xr) {
+        paintRun(y, xl, xr);
+    }
+}
+
+bool fillShapeAt(int x, int y, float fillColor[3]) {
+    static vector<int> discWidth;
+    midpointExtents(CIRCLE_R, discWidth);
+    int dx = abs(x - CIRCLE_X), dy = abs(y - CIRCLE_Y);
+
+    fb.setColor(fillColor[0], fillColor[1], fillColor[2]);
+    if (dy <= CIRCLE_R && dx <= discWidth[dy]) {
+        ringFiller.fill(CIRCLE_X, CIRCLE_Y, 0, CIRCLE_R, paintClipped);
+        drawCircleMidpoint(CIRCLE_X, CIRCLE_Y, CIRCLE_R);
+    } else if (insidePolygon(TRIANGLE_X, TRIANGLE_Y, 3, x, y)) {
+        polygonFiller.fill(TRIANGLE_X, TRIANGLE_Y, 3, paintClipped);
+        fb.setColor(0.0, 1.0, 0.0);
+        drawPolygonOutline(TRIANGLE_X, TRIANGLE_Y, 3);
+    } else if (insidePolygon(SQUARE_X, SQUARE_Y, 4, x, y)) {
+        polygonFiller.fill(SQUARE_X, SQUARE_Y, 4, paintClipped);
+        fb.setColor(1.0, 0.0, 0.0);
+        drawPolygonOutline(SQUARE_X, SQUARE_Y, 4);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void display() {
+    presentFramebuffer(fb);
     glFlush();
 }
 
 int main(int argc, char** argv) {
+    drawScene();
+
+    // Headless: Que_1 --headless out.png [--style name] [--label | --geometry]
+    //                 [seedX seedY]...
+    if (const char* out = headlessPath(argc, argv)) {
+        int arg = 3;
+        if (arg + 1 < argc && strcmp(argv[arg], "--style") == 0) {
+            for (int i = 0; i < STYLE_COUNT; i++) {
+                if (strcmp(argv[arg + 1], STYLE_NAMES[i]) == 0) {
+                    fillStyle = i;
+                }
+            }
+            arg += 2;
+        }
+        if (arg < argc && strcmp(argv[arg], "--label") == 0) {
+            labelMode = true;
+            labelAllRegions();
+            arg++;
+        } else if (arg < argc && strcmp(argv[arg], "--geometry") == 0) {
+            geometryMode = true;
+            arg++;
+        }
+        for (; arg + 1 < argc; arg += 2) {
+            int x = atoi(argv[arg]), y = atoi(argv[arg + 1]);
+            if (geometryMode) {
+                fillShapeAt(x, y, FILL_COLOR);
+            } else if (labelMode) {
+                fillRegion(x, y, FILL_COLOR);
+            } else {
+                floodFill4N(x, y, FILL_COLOR, BACKGROUND_COLOR);
+            }
+        }
+        return writePng(out, fb) ? 0 : 1;
+    }
+
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_SINGLE | GLUT_RGB);
     glutInitWindowSize(WINDOW_SIZE, WINDOW_SIZE);
@@ -147,9 +330,14 @@ int main(int argc, char** argv) {
 
     initOpenGL();
     glutDisplayFunc(display);
+    glutReshapeFunc(reshape);
     glutMouseFunc(mouse);
+    glutKeyboardFunc(keyboard);
 
     cout << "Click inside a shape to fill it (Fill Color: Magenta)." << endl;
+    cout << "Press L to toggle label-all-regions mode." << endl;
+    cout << "Press G to toggle geometry fill mode (no seed, no pixel reads)." << endl;
+    cout << "Press S to cycle the fill style (solid, pattern, linear, radial, hue)." << endl;
 
     glutMainLoop();
 
@@ -1,5 +1,10 @@
 #include <GL/freeglut.h>
 #include <bits/stdc++.h>
+#include "../common/framebuffer_gl.h"
+#include "../common/glyph_atlas.h"
+#include "../common/image_io.h"
+#include "../common/line_kernels.h"
+#include "../common/thick_line.h"
 using namespace std;
 
 // --- Global Constants ---
@@ -29,36 +34,31 @@ int x1_in, y1_in, x2_in, y2_in;
 int width_in = 1;
 bool has_input = false;
 
+// Software render target for the drawing screen (text is still drawn by GL)
+Framebuffer fb(WINDOW_SIZE, WINDOW_SIZE);
+
 // --- Utility Functions ---
 
 int to_screen_x(int x) { return x + MAX_COORD; }
 int to_screen_y(int y) { return y + MAX_COORD; }
 
 void draw_pixel(int x, int y, float r, float g, float b) {
-    glColor3f(r, g, b);
-    glBegin(GL_POINTS);
-    glVertex2i(to_screen_x(x), to_screen_y(y));
-    glEnd();
+    fb.color = packRGBf(r, g, b);
+    fb.putPixel(to_screen_x(x), to_screen_y(y));
 }
 
 // Function to draw large text for prompts
 void draw_text_large(float x, float y, float r, float g, float b,
                      const string& text) {
     glColor3f(r, g, b);
-    glRasterPos2f(x, y);
-    for (char c : text) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
-    }
+    drawBitmapText(x, y, text, GLUT_BITMAP_HELVETICA_18);
 }
 
 // Function to draw small text for axes labels
 void draw_text_small(float x, float y, float r, float g, float b,
                      const string& text) {
     glColor3f(r, g, b);
-    glRasterPos2f(x, y);
-    for (char c : text) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_10, c);
-    }
+    drawBitmapText(x, y, text, GLUT_BITMAP_HELVETICA_10);
 }
 
 // Helper to convert string to int safely
@@ -76,62 +76,30 @@ int parse_int(const string& str) {
 
 // --- Bresenham's Algorithms (Unchanged) ---
 
+// Octant picked once per line (see common/line_kernels.h)
 void standard_bresenham(int x1, int y1, int x2, int y2) {
-    int dx = abs(x2 - x1);
-    int dy = abs(y2 - y1);
-    int sx = (x1 < x2) ? 1 : -1;
-    int sy = (y1 < y2) ? 1 : -1;
-    int err = dx - dy;
-    int x = x1;
-    int y = y1;
-
-    while (true) {
-        draw_pixel(x, y, 0.0, 0.0, 0.0);
-        if (x == x2 && y == y2)
-            break;
-        int e2 = 2 * err;
-        if (e2 > -dy) {
-            err -= dy;
-            x += sx;
-        }
-        if (e2 < dx) {
-            err += dx;
-            y += sy;
-        }
-    }
+    bresenhamLine(x1, y1, x2, y2,
+                  [](int x, int y) { draw_pixel(x, y, 0.0, 0.0, 0.0); });
 }
 
+// Fills the W-wide quad around the line one horizontal span per scanline,
+// so every covered pixel is written once and diagonals have no gaps.
 void thick_bresenham(int x1, int y1, int x2, int y2, int w) {
-    int half_w = (w - 1) / 2;
-    int dx = abs(x2 - x1);
-    int dy = abs(y2 - y1);
-    bool steep = dy > dx;
-
-    if (steep) {
-        for (int offset = -half_w; offset <= half_w; ++offset) {
-            standard_bresenham(x1 + offset, y1, x2 + offset, y2);
-        }
-    } else {
-        for (int offset = -half_w; offset <= half_w; ++offset) {
-            standard_bresenham(x1, y1 + offset, x2, y2 + offset);
-        }
-    }
+    fb.setColor(0.0, 0.0, 0.0);
+    drawThickLine(fb, to_screen_x(x1), to_screen_y(y1), to_screen_x(x2),
+                  to_screen_y(y2), w);
 }
 
 // --- Drawing Screen Functions (Unchanged) ---
 
 void draw_coordinate_system() {
-    glColor3f(0.0f, 0.0f, 1.0f);
+    fb.setColor(0.0f, 0.0f, 1.0f);
 
     // 1. Draw X and Y Axes (blue)
-    glBegin(GL_LINES);
-    glVertex2i(0, MAX_COORD);
-    glVertex2i(WINDOW_SIZE, MAX_COORD);
-    glVertex2i(MAX_COORD, 0);
-    glVertex2i(MAX_COORD, WINDOW_SIZE);
-    glEnd();
-
-    // 2. Draw Grid and Numbers (blue)
+    fb.drawLine(0, MAX_COORD, WINDOW_SIZE - 1, MAX_COORD);
+    fb.drawLine(MAX_COORD, 0, MAX_COORD, WINDOW_SIZE - 1);
+
+    // 2. Draw Grid ticks (blue)
     for (int current_coord = -MAX_COORD + GRID_SPACING;
          current_coord < MAX_COORD; current_coord += GRID_SPACING) {
         if (current_coord == 0)
@@ -140,12 +108,21 @@ void draw_coordinate_system() {
         int screen_pos_x = to_screen_x(current_coord);
         int screen_pos_y = to_screen_y(current_coord);
 
-        glBegin(GL_LINES);
-        glVertex2i(screen_pos_x, MAX_COORD - 3);
-        glVertex2i(screen_pos_x, MAX_COORD + 3);
-        glVertex2i(MAX_COORD - 3, screen_pos_y);
-        glVertex2i(MAX_COORD + 3, screen_pos_y);
-        glEnd();
+        fb.drawLine(screen_pos_x, MAX_COORD - 3, screen_pos_x, MAX_COORD + 3);
+        fb.drawLine(MAX_COORD - 3, screen_pos_y, MAX_COORD + 3, screen_pos_y);
+    }
+}
+
+// Axis numbers go on top of the presented framebuffer, since the bitmap font
+// is only available through GLUT
+void draw_axis_labels() {
+    for (int current_coord = -MAX_COORD + GRID_SPACING;
+         current_coord < MAX_COORD; current_coord += GRID_SPACING) {
+        if (current_coord == 0)
+            continue;
+
+        int screen_pos_x = to_screen_x(current_coord);
+        int screen_pos_y = to_screen_y(current_coord);
 
         if (current_coord % GRID_SPACING == 0) {
             draw_text_small(screen_pos_x - 10, MAX_COORD - 15, 0.0f, 0.0f, 1.0f,
@@ -291,26 +268,32 @@ void process_input() {
     glutPostRedisplay(); // Redraw window
 }
 
+// Rasterizes the axes and the requested line into the framebuffer
+void render_scene() {
+    fb.clear(packRGBA(255, 255, 255));
+    fb.pointSize = 1;
+    draw_coordinate_system();
+
+    if (has_input) {
+        fb.pointSize = 2; // glPointSize(1.5) rounds to 2 pixels
+        if (choice == 1) {
+            standard_bresenham(x1_in, y1_in, x2_in, y2_in);
+        } else if (choice == 2) {
+            thick_bresenham(x1_in, y1_in, x2_in, y2_in, width_in);
+        }
+    }
+}
+
 // --- OpenGL Callback Functions ---
 
 void display() {
     if (app_mode == INPUT_MODE) {
         draw_input_screen();
     } else if (app_mode == DRAWING_MODE) {
-        // Drawing Screen Setup
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+        render_scene();
         glClear(GL_COLOR_BUFFER_BIT);
-        glPointSize(1.0);
-        draw_coordinate_system();
-
-        if (has_input) {
-            glPointSize(1.5);
-            if (choice == 1) {
-                standard_bresenham(x1_in, y1_in, x2_in, y2_in);
-            } else if (choice == 2) {
-                thick_bresenham(x1_in, y1_in, x2_in, y2_in, width_in);
-            }
-        }
+        presentFramebuffer(fb);
+        draw_axis_labels();
 
         // Simple instruction to close the window
         draw_text_small(10, 10, 0.5f, 0.0f, 0.0f,
@@ -350,6 +333,24 @@ void init() {
 }
 
 int main(int argc, char** argv) {
+    // Headless: task_1 --headless out.png <choice> <x1> <y1> <x2> <y2> [W]
+    if (const char* out = headlessPath(argc, argv)) {
+        if (argc < 8) {
+            cerr << "Usage: " << argv[0]
+                 << " --headless out.png choice x1 y1 x2 y2 [W]\n";
+            return 1;
+        }
+        choice = parse_int(argv[3]);
+        x1_in = parse_int(argv[4]);
+        y1_in = parse_int(argv[5]);
+        x2_in = parse_int(argv[6]);
+        y2_in = parse_int(argv[7]);
+        width_in = (choice == 2 && argc > 8) ? max(1, parse_int(argv[8])) : 1;
+        has_input = true;
+        render_scene();
+        return writePng(out, fb) ? 0 : 1;
+    }
+
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_SINGLE | GLUT_RGB);
     glutInitWindowSize(WINDOW_SIZE, WINDOW_SIZE);
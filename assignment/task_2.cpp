@@ -1,5 +1,7 @@
 #include <GL/freeglut.h>
 #include <bits/stdc++.h>
+#include "../common/color.h"
+#include "../common/ring.h"
 using namespace std;
 
 // --- Global Constants ---
@@ -15,64 +17,6 @@ const float MAX_THICKNESS = 5.0f; // Max thickness in glPointSize units
 
 // --- Utility Functions ---
 
-/**
- * @brief Converts HSV to RGB color model.
- * @param h Hue (0-360 degrees)
- * @param s Saturation (0-1)
- * @param v Value (0-1)
- * @param r Pointer to store Red component (0-1)
- * @param g Pointer to store Green component (0-1)
- * @param b Pointer to store Blue component (0-1)
- */
-void hsvToRgb(float h, float s, float v, float* r, float* g, float* b) {
-    if (s == 0.0f) {
-        *r = *g = *b = v;
-        return;
-    }
-
-    // Normalize H to [0, 6)
-    float h_norm = h / 60.0f;
-    int i = (int)floor(h_norm);
-    float f = h_norm - i;
-
-    float p = v * (1.0f - s);
-    float q = v * (1.0f - s * f);
-    float t = v * (1.0f - s * (1.0f - f));
-
-    switch (i % 6) {
-    case 0:
-        *r = v;
-        *g = t;
-        *b = p;
-        break;
-    case 1:
-        *r = q;
-        *g = v;
-        *b = p;
-        break;
-    case 2:
-        *r = p;
-        *g = v;
-        *b = t;
-        break;
-    case 3:
-        *r = p;
-        *g = q;
-        *b = v;
-        break;
-    case 4:
-        *r = t;
-        *g = p;
-        *b = v;
-        break;
-    case 5:
-        *r = v;
-        *g = p;
-        *b = q;
-        break;
-    }
-}
-
 // Function to set the color based on the current circle index (i)
 void set_gradient_color(int i) {
     // Normalized position of the circle (0.0 for inner, 1.0 for outer)
@@ -92,50 +36,30 @@ void set_gradient_color(int i) {
     glColor3f(red, green, blue);
 }
 
-// Function to draw a pixel on the screen
-void draw_pixel(int x, int y, int cx, int cy, float size) {
-    glPointSize(size);
-    glBegin(GL_POINTS);
-    // Draw the point relative to the center (cx, cy)
-    glVertex2i(cx + x, cy + y);
-    glEnd();
-}
-
 // --- Midpoint Circle Drawing Functions ---
 
-// Draws the 8 symmetrical points
-void circle_plot_points(int cx, int cy, int x, int y, float size) {
-    draw_pixel(x, y, cx, cy, size);
-    draw_pixel(-x, y, cx, cy, size);
-    draw_pixel(x, -y, cx, cy, size);
-    draw_pixel(-x, -y, cx, cy, size);
-    draw_pixel(y, x, cx, cy, size);
-    draw_pixel(-y, x, cx, cy, size);
-    draw_pixel(y, -x, cx, cy, size);
-    draw_pixel(-y, -x, cx, cy, size);
-}
+// Quad vertices of the current ring, reused between rings and frames
+vector<GLint> ring_quads;
+RingFiller ring_filler;
 
-// Midpoint Circle Algorithm implementation
+// Draws a thick ring as the spans between two midpoint circles (see
+// common/ring.h) and submits the whole ring with one glDrawArrays call
 void midpoint_circle(int cx, int cy, int radius, float thickness) {
-    int x = 0;
-    int y = radius;
-    // Initial decision parameter P0 = 1 - r (for integer math)
-    int p = 1 - radius;
-
-    circle_plot_points(cx, cy, x, y, thickness);
-
-    while (x < y) {
-        x++;
-        if (p < 0) {
-            // Choose E (East)
-            p += 2 * x + 1;
-        } else {
-            // Choose SE (South-East)
-            y--;
-            p += 2 * (x - y) + 1;
-        }
-        circle_plot_points(cx, cy, x, y, thickness);
-    }
+    // A glPointSize(thickness) point covers round(thickness) pixels
+    int size = max(1, (int)(thickness + 0.5f));
+    int outer = radius + size / 2;
+    int inner = radius - (size - 1) / 2;
+
+    ring_quads.clear();
+    ring_filler.fill(cx, cy, inner, outer, [](int y, int xa, int xb) {
+        GLint quad[8] = {xa, y, xb + 1, y, xb + 1, y + 1, xa, y + 1};
+        ring_quads.insert(ring_quads.end(), quad, quad + 8);
+    });
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_INT, 0, ring_quads.data());
+    glDrawArrays(GL_QUADS, 0, (GLsizei)(ring_quads.size() / 2));
+    glDisableClientState(GL_VERTEX_ARRAY);
 }
 
 // --- Drawing Function ---
@@ -1,5 +1,13 @@
 #include <GL/freeglut.h>
 #include <bits/stdc++.h>
+#include "../common/clip_batch.h"
+#include "../common/convex_clip.h"
+#include "../common/density_raster.h"
+#include "../common/framebuffer_gl.h"
+#include "../common/glyph_atlas.h"
+#include "../common/polygon_clip.h"
+#include "../common/polygon_fill.h"
+#include "../common/segment_grid.h"
 using namespace std;
 
 // --- Global Constants ---
@@ -21,6 +29,11 @@ const int WINDOW_INPUT_MODE = 1;
 const int LINE_INPUT_MODE = 2;
 const int CLIPPING_MODE = 3;
 
+// Shapes of the clip window, fitted to the two clicked corners (H cycles)
+const int RECT_WINDOW = 0;
+const int HEXAGON_WINDOW = 1;
+const int ROTATED_WINDOW = 2;
+
 // --- Data Structures ---
 struct Point {
     float x, y;
@@ -37,11 +50,23 @@ vector<Point> visible_points;
 int app_mode = WINDOW_INPUT_MODE;
 int click_count = 0;
 float xmin = 0, ymin = 0, xmax = 0, ymax = 0;
+int window_shape = RECT_WINDOW;
 
 vector<LineSegment> lines_to_clip;
+size_t lines_version = 0; // Bumped on every change to lines_to_clip
 Point current_line_start = {0, 0};
+Point chain_start = {0, 0}; // First point of the line being chained
+size_t chain_first_line = 0; // Its first line in lines_to_clip
 bool drawing_new_segment = true;
 
+// A chain closed by clicking its first point again, as the range
+// [first, end) of lines_to_clip. Recorded by mouse() when it closes, so
+// chains that merely touch are never taken for one shape.
+struct ClosedShape {
+    size_t first, end;
+};
+vector<ClosedShape> closed_shapes;
+
 // --- Utility Functions ---
 
 // Global variables for coordinate system transformation
@@ -50,29 +75,31 @@ float y_center_offset = 0.0f;
 float x_scale = 1.0f;
 float y_scale = 1.0f;
 
+// View zoom (+/- on the results screen) about a logical point, which is
+// drawn at the centre of the drawing area
+float zoom = 1.0f;
+Point view_center = {0, 0};
+
 // Transform logical (mathematical) coordinates to screen (OpenGL) coordinates
 Point logical_to_screen(float lx, float ly) {
     Point screen_p;
-    screen_p.x = x_center_offset + lx * x_scale;
-    screen_p.y = y_center_offset + ly * y_scale;
+    screen_p.x = x_center_offset + (lx - view_center.x) * x_scale * zoom;
+    screen_p.y = y_center_offset + (ly - view_center.y) * y_scale * zoom;
     return screen_p;
 }
 
 // Transform screen (OpenGL) coordinates to logical (mathematical) coordinates
 Point screen_to_logical(float sx, float sy) {
     Point logical_p;
-    logical_p.x = (sx - x_center_offset) / x_scale;
-    logical_p.y = (sy - y_center_offset) / y_scale;
+    logical_p.x = (sx - x_center_offset) / (x_scale * zoom) + view_center.x;
+    logical_p.y = (sy - y_center_offset) / (y_scale * zoom) + view_center.y;
     return logical_p;
 }
 
 void draw_text(float x, float y, float r, float g, float b, const string& text,
                void* font) {
     glColor3f(r, g, b);
-    glRasterPos2f(x, y);
-    for (char c : text) {
-        glutBitmapCharacter(font, c);
-    }
+    drawBitmapText(x, y, text, font);
 }
 
 void draw_ui_header(const string& title, const string& instruction,
@@ -100,20 +127,33 @@ void draw_ui_header(const string& title, const string& instruction,
               GLUT_BITMAP_HELVETICA_12);
 }
 
+// The clip window as a convex polygon (logical coordinates): the clicked
+// rectangle, the hexagon touching its four sides, or the rectangle turned
+// by 30 degrees about its centre.
+ConvexWindow current_window() {
+    float cx = (xmin + xmax) / 2, cy = (ymin + ymax) / 2;
+    float hw = (xmax - xmin) / 2, hh = (ymax - ymin) / 2;
+    if (window_shape == HEXAGON_WINDOW) {
+        float xs[6] = {cx + hw, cx + hw / 2, cx - hw / 2,
+                       cx - hw, cx - hw / 2, cx + hw / 2};
+        float ys[6] = {cy, cy + hh, cy + hh, cy, cy - hh, cy - hh};
+        return ConvexWindow(xs, ys, 6);
+    }
+    if (window_shape == ROTATED_WINDOW)
+        return ConvexWindow::rotated(cx, cy, hw, hh, M_PI / 6);
+    return ConvexWindow::rectangle({xmin, ymin, xmax, ymax});
+}
+
 void draw_clipping_window() {
-    // The window coordinates (xmin, ymin, etc.) are in logical space now.
-    Point p1 = logical_to_screen(xmin, ymin);
-    Point p2 = logical_to_screen(xmax, ymin);
-    Point p3 = logical_to_screen(xmax, ymax);
-    Point p4 = logical_to_screen(xmin, ymax);
+    ConvexWindow window = current_window();
 
     glColor3f(0.0f, 0.0f, 0.0f); // Black window frame
     glLineWidth(2.0f);
     glBegin(GL_LINE_LOOP);
-    glVertex2f(p1.x, p1.y);
-    glVertex2f(p2.x, p2.y);
-    glVertex2f(p3.x, p3.y);
-    glVertex2f(p4.x, p4.y);
+    for (size_t i = 0; i < window.xs.size(); ++i) {
+        Point p = logical_to_screen(window.xs[i], window.ys[i]);
+        glVertex2f(p.x, p.y);
+    }
     glEnd();
 }
 
@@ -193,133 +233,313 @@ void draw_coordinate_system() {
 
 // --- Liang-Barsky Algorithm (Uses logical coordinates) ---
 
-bool liang_barsky_clip(float x0, float y0, float x1, float y1, float& tx0,
-                       float& tx1) {
-    float dx = x1 - x0;
-    float dy = y1 - y0;
-    float p[4], q[4];
-    float t0 = 0.0, t1 = 1.0;
-
-    p[0] = -dx;
-    q[0] = x0 - xmin;
-    p[1] = dx;
-    q[1] = xmax - x0;
-    p[2] = -dy;
-    q[2] = y0 - ymin;
-    p[3] = dy;
-    q[3] = ymax - y0;
-
-    for (int i = 0; i < 4; i++) {
-        if (fabs(p[i]) < 1e-6) {
-            if (q[i] < 0.0f)
-                return false;
-        } else {
-            float t = q[i] / p[i];
-            if (p[i] < 0.0f) {
-                t0 = max(t0, t);
-            } else {
-                t1 = min(t1, t);
-            }
+// Lines are clipped in batches (common/clip_batch.h): the endpoints are
+// kept in structure-of-arrays form and clipped several segments per SIMD
+// instruction, giving a t-interval and an accept bit per line. Results are
+// cached by line index, so a redraw only clips the lines added since the
+// previous one; a reset clips everything again. When the clip window
+// changes (W), a uniform grid over the lines finds the ones near the new
+// window, so lines far from it are never clipped (common/segment_grid.h).
+// Hexagonal and rotated windows are clipped with Cyrus-Beck
+// (common/convex_clip.h) and cached the same way, keyed on the window's
+// shape and vertices: only new lines are clipped until the window changes.
+SegmentSoA segment_batch;
+IncrementalClipper clip_cache;
+SegmentGrid segment_grid(-COORD_RANGE_X, -COORD_RANGE_Y, COORD_RANGE_X,
+                         COORD_RANGE_Y, 56, 30);
+ClippedSegments grid_hits;
+ClipIntervals convex_clipped;
+int convex_shape = -1;              // Window convex_clipped is for, -1: none
+vector<float> convex_xs, convex_ys;
+size_t convex_count = 0;            // Lines clipped into convex_clipped
+int points_shape = RECT_WINDOW; // Window shape visible_points was built for
+
+// Clips the lines added since the last call against a convex window, or
+// all of them when the window changed. Returns the first line whose
+// result is new.
+size_t update_convex_clip(const ConvexWindow& window) {
+    size_t n = segment_batch.size();
+    bool same = convex_shape == window_shape && convex_xs == window.xs &&
+                convex_ys == window.ys && convex_count <= n;
+    size_t fresh = same ? convex_count : 0;
+    if (!same) {
+        convex_shape = window_shape;
+        convex_xs = window.xs;
+        convex_ys = window.ys;
+    }
+    // Restart at a whole accept word, since the batch rewrites whole words
+    size_t from = fresh & ~(size_t)63;
+    ClipIntervals& c = convex_clipped;
+    c.t0.resize(n);
+    c.t1.resize(n);
+    c.accept.resize((n + 63) / 64);
+    cyrusBeckBatch(segment_batch.x0.data() + from,
+                   segment_batch.y0.data() + from,
+                   segment_batch.x1.data() + from,
+                   segment_batch.y1.data() + from, n - from, window,
+                   c.t0.data() + from, c.t1.data() + from,
+                   c.accept.data() + from / 64);
+    convex_count = n;
+    return fresh;
+}
+
+// Brings the clip results and visible_points up to date with lines_to_clip
+void update_clip_cache() {
+    for (size_t i = segment_batch.size(); i < lines_to_clip.size(); ++i) {
+        const auto& line = lines_to_clip[i];
+        segment_batch.push(line.p1.x, line.p1.y, line.p2.x, line.p2.y);
+    }
+    segment_grid.insertFrom(segment_batch);
+
+    ClipWindow window = {xmin, ymin, xmax, ymax};
+    size_t first = 0;
+    if (window_shape != RECT_WINDOW) {
+        first = update_convex_clip(current_window());
+    } else if (clip_cache.clippedAgainst(window)) {
+        first = clip_cache.update(segment_batch, window);
+    } else {
+        segment_grid.clip(segment_batch, window, grid_hits);
+        clip_cache.assign(segment_batch.size(), window, grid_hits);
+    }
+    const ClipIntervals& clipped =
+        window_shape == RECT_WINDOW ? clip_cache.result() : convex_clipped;
+    if (points_shape != window_shape)
+        first = 0;
+    points_shape = window_shape;
+
+    // Two visible endpoints per accepted line, in line order
+    visible_points.resize(2 * clipped.acceptedBefore(first));
+    for (size_t i = first; i < lines_to_clip.size(); ++i) {
+        if (!clipped.accepted(i))
+            continue;
+        const auto& line = lines_to_clip[i];
+        float dx = line.p2.x - line.p1.x;
+        float dy = line.p2.y - line.p1.y;
+        visible_points.push_back({line.p1.x + clipped.t0[i] * dx,
+                                  line.p1.y + clipped.t0[i] * dy});
+        visible_points.push_back({line.p1.x + clipped.t1[i] * dx,
+                                  line.p1.y + clipped.t1[i] * dy});
+    }
+}
+
+// --- Level of Detail ---
+
+// Drawing every line and label one by one stops scaling long before 100k
+// lines, so the results are sorted by their size on screen:
+//   - lines shorter than a pixel are counted into a density raster
+//     (common/density_raster.h) and drawn as one image;
+//   - up to LINE_LIMIT longer lines are drawn individually from one vertex
+//     array; past that they are rasterized into the density raster too;
+//   - endpoint dots and P# labels are drawn only when at most LABEL_LIMIT
+//     of them are in view, i.e. once zoomed in far enough.
+// The result is cached and rebuilt only when the lines, the window or the
+// view change, so a redraw costs the same few draw calls however many
+// lines are loaded.
+const size_t LINE_LIMIT = 50000;
+const size_t LABEL_LIMIT = 150;
+
+struct LodFrame {
+    vector<float> original_lines, clipped_lines; // Screen x, y per vertex
+    vector<float> shape_fills;                   // One line per fill span
+    vector<float> point_xy;                      // Endpoints in view
+    vector<int> point_label;                     // Their P# numbers
+};
+
+LodFrame lod;
+DensityRaster original_density((int)DRAWING_AREA_WIDTH,
+                               (int)DRAWING_AREA_HEIGHT);
+DensityRaster clipped_density((int)DRAWING_AREA_WIDTH,
+                              (int)DRAWING_AREA_HEIGHT);
+tuple<size_t, float, float, float, float, float, float, float, int> lod_key;
+bool lod_built = false;
+
+bool in_drawing_area(const Point& p) {
+    return p.x >= 0 && p.y >= 0 && p.x <= DRAWING_AREA_WIDTH &&
+           p.y <= DRAWING_AREA_HEIGHT;
+}
+
+// Puts one screen-space segment in the vertex array or the density raster,
+// or drops it when it is out of view
+void add_lod_segment(const Point& a, const Point& b, vector<float>& lines,
+                     DensityRaster& density) {
+    if (max(a.x, b.x) < 0 || min(a.x, b.x) > DRAWING_AREA_WIDTH ||
+        max(a.y, b.y) < 0 || min(a.y, b.y) > DRAWING_AREA_HEIGHT)
+        return;
+    if (fabs(b.x - a.x) < 1 && fabs(b.y - a.y) < 1)
+        density.add((a.x + b.x) / 2, (a.y + b.y) / 2);
+    else if (lines.size() < 4 * LINE_LIMIT)
+        lines.insert(lines.end(), {a.x, a.y, b.x, b.y});
+    else
+        density.addLine(a.x, a.y, b.x, b.y);
+}
+
+// Closed shapes are clipped as whole polygons against the window
+// (Sutherland-Hodgman, common/polygon_clip.h) rather than as separate
+// segments, and their visible part is filled. The polygon is clipped
+// again to the drawing area on screen, so a zoomed-in shape spans at most
+// the rows in view.
+PolygonClipper polygon_clipper;
+PolygonFiller polygon_filler;
+vector<float> shape_x, shape_y;
+
+void build_shape_fills(const ConvexWindow& window) {
+    const ClipWindow view = {0, 0, DRAWING_AREA_WIDTH, DRAWING_AREA_HEIGHT};
+    lod.shape_fills.clear();
+    for (const ClosedShape& shape : closed_shapes) {
+        shape_x.clear();
+        shape_y.clear();
+        for (size_t k = shape.first; k < shape.end; ++k) {
+            shape_x.push_back(lines_to_clip[k].p1.x);
+            shape_y.push_back(lines_to_clip[k].p1.y);
         }
+        int n = polygon_clipper.clipPolygon(
+            shape_x.data(), shape_y.data(), (int)shape_x.size(), window);
+
+        shape_x.clear();
+        shape_y.clear();
+        for (int k = 0; k < n; ++k) {
+            Point p = logical_to_screen(polygon_clipper.x()[k],
+                                        polygon_clipper.y()[k]);
+            shape_x.push_back(p.x);
+            shape_y.push_back(p.y);
+        }
+        n = polygon_clipper.clipPolygon(shape_x.data(), shape_y.data(), n,
+                                        view);
+        polygon_filler.fill(polygon_clipper.x(), polygon_clipper.y(), n,
+                            [](int y, int x_left, int x_right) {
+                                lod.shape_fills.insert(
+                                    lod.shape_fills.end(),
+                                    {(float)x_left, y + 0.5f,
+                                     (float)x_right + 1, y + 0.5f});
+                            });
     }
+}
 
-    if (t0 > t1) {
-        return false;
+void build_lod_frame() {
+    auto key = make_tuple(lines_version, zoom, view_center.x,
+                          view_center.y, xmin, ymin, xmax, ymax, window_shape);
+    if (lod_built && key == lod_key)
+        return;
+    lod_key = key;
+    lod_built = true;
+
+    lod.original_lines.clear();
+    lod.clipped_lines.clear();
+    original_density.clear();
+    clipped_density.clear();
+    for (const auto& line : lines_to_clip)
+        add_lod_segment(logical_to_screen(line.p1.x, line.p1.y),
+                        logical_to_screen(line.p2.x, line.p2.y),
+                        lod.original_lines, original_density);
+    // visible_points holds the two clipped endpoints of each visible line
+    for (size_t i = 0; i + 1 < visible_points.size(); i += 2)
+        add_lod_segment(
+            logical_to_screen(visible_points[i].x, visible_points[i].y),
+            logical_to_screen(visible_points[i + 1].x, visible_points[i + 1].y),
+            lod.clipped_lines, clipped_density);
+
+    build_shape_fills(current_window());
+
+    lod.point_xy.clear();
+    lod.point_label.clear();
+    for (size_t i = 0; i < visible_points.size(); ++i) {
+        Point p = logical_to_screen(visible_points[i].x, visible_points[i].y);
+        if (!in_drawing_area(p))
+            continue;
+        if (lod.point_label.size() == LABEL_LIMIT) { // Too many to read
+            lod.point_xy.clear();
+            lod.point_label.clear();
+            break;
+        }
+        lod.point_xy.insert(lod.point_xy.end(), {p.x, p.y});
+        lod.point_label.push_back((int)i + 1);
     }
+}
 
-    tx0 = t0;
-    tx1 = t1;
-    return true;
+void draw_lines(const vector<float>& xy, GLenum mode) {
+    if (xy.empty())
+        return;
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, xy.data());
+    glDrawArrays(mode, 0, (GLsizei)(xy.size() / 2));
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+void draw_density(DensityRaster& density, uint32_t color) {
+    if (density.empty())
+        return;
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    presentFramebuffer(density.image(color));
+    glDisable(GL_BLEND);
+}
+
+void draw_shape_fills() {
+    glColor3f(0.8f, 0.95f, 0.8f); // Light green fill
+    glLineWidth(1.0f);
+    draw_lines(lod.shape_fills, GL_LINES);
+}
+
+void draw_lod_frame() {
+    // Original lines (RED)
+    draw_density(original_density, packRGBA(255, 0, 0));
+    glColor3f(1.0f, 0.0f, 0.0f);
+    glLineWidth(1.0f);
+    draw_lines(lod.original_lines, GL_LINES);
+
+    // Clipped segments (GREEN, THICK)
+    draw_density(clipped_density, packRGBA(0, 204, 0));
+    glColor3f(0.0f, 0.8f, 0.0f);
+    glLineWidth(4.0f);
+    draw_lines(lod.clipped_lines, GL_LINES);
+
+    // Large dots on the visible/intersection points, and their labels
+    glColor3f(0.0f, 0.0f, 0.8f);
+    glPointSize(8.0f);
+    draw_lines(lod.point_xy, GL_POINTS);
+    for (size_t i = 0; i < lod.point_label.size(); ++i) {
+        string label = "P" + to_string(lod.point_label[i]);
+        // Draw the label near the point (offset by 8 units)
+        draw_text(lod.point_xy[2 * i] + 8, lod.point_xy[2 * i + 1] + 8, 0.0f,
+                  0.0f, 0.8f, label, GLUT_BITMAP_HELVETICA_12);
+    }
 }
 
 // --- Display Modes ---
 
 void draw_clipping_mode() {
     glClear(GL_COLOR_BUFFER_BIT);
-    visible_points.clear(); // Clear points list for this drawing cycle
 
     // Divide window: 70% for drawing, 30% for coordinate list
     const float LIST_AREA_START_X = WINDOW_WIDTH * 0.7;
 
-    draw_ui_header("STEP 3: Clipping Results (Liang-Barsky) - All Quadrants",
+    string algorithm =
+        window_shape == RECT_WINDOW ? "Liang-Barsky" : "Cyrus-Beck";
+    draw_ui_header("STEP 3: Clipping Results (" + algorithm +
+                       ") - All Quadrants",
                    "Original Lines (RED) | Clipped Segments (GREEN) | "
-                   "Intersections (BLUE/P#)",
+                   "Intersections (BLUE/P#) | W: new window, H: window "
+                   "shape, +/-: zoom.",
                    0.0f, 0.5f, 0.0f);
 
-    // 1. Draw Axis/Grid in the main area
+    // 1. Draw Axis/Grid in the main area, which zoomed-in geometry must
+    // not leave
+    glScissor(0, 0, (GLsizei)DRAWING_AREA_WIDTH, (GLsizei)DRAWING_AREA_HEIGHT);
+    glEnable(GL_SCISSOR_TEST);
     draw_coordinate_system();
 
-    // 2. Draw Clipping Window
-    draw_clipping_window();
-
-    // 3. Process and Draw Lines
-    for (const auto& line : lines_to_clip) {
-        float x0 = line.p1.x; // Logical x0
-        float y0 = line.p1.y; // Logical y0
-        float x1 = line.p2.x; // Logical x1
-        float y1 = line.p2.y; // Logical y1
-
-        Point screen_p1 = logical_to_screen(x0, y0);
-        Point screen_p2 = logical_to_screen(x1, y1);
-
-        float tx0, tx1;
+    // 2. Process Lines and closed shapes, by level of detail
+    update_clip_cache();
+    build_lod_frame();
 
-        // Draw the ORIGINAL line segment (RED) using screen coordinates
-        glColor3f(1.0f, 0.0f, 0.0f);
-        glLineWidth(1.0f);
-        glBegin(GL_LINES);
-        glVertex2f(screen_p1.x, screen_p1.y);
-        glVertex2f(screen_p2.x, screen_p2.y);
-        glEnd();
-
-        // Execute Liang-Barsky using logical coordinates
-        if (liang_barsky_clip(x0, y0, x1, y1, tx0, tx1)) {
-            // Calculate clipped endpoints in logical coordinates
-            float clipped_lx0 = x0 + tx0 * (x1 - x0);
-            float clipped_ly0 = y0 + tx0 * (y1 - y0);
-            float clipped_lx1 = x0 + tx1 * (x1 - x0);
-            float clipped_ly1 = y0 + tx1 * (y1 - y0);
-
-            // Convert clipped endpoints to screen coordinates for drawing
-            Point clipped_screen_p1 =
-                logical_to_screen(clipped_lx0, clipped_ly0);
-            Point clipped_screen_p2 =
-                logical_to_screen(clipped_lx1, clipped_ly1);
-
-            // Add the visible endpoints (logical coordinates) to the list
-            visible_points.push_back({clipped_lx0, clipped_ly0});
-            visible_points.push_back({clipped_lx1, clipped_ly1});
-
-            // Draw the CLIPPED segment (GREEN, THICK)
-            glColor3f(0.0f, 0.8f, 0.0f);
-            glLineWidth(4.0f);
-            glBegin(GL_LINES);
-            glVertex2f(clipped_screen_p1.x, clipped_screen_p1.y);
-            glVertex2f(clipped_screen_p2.x, clipped_screen_p2.y);
-            glEnd();
-
-            // Draw large dots on the intersection/visible endpoints
-            glColor3f(0.0f, 0.0f, 0.8f);
-            glPointSize(8.0f);
-            glBegin(GL_POINTS);
-            glVertex2f(clipped_screen_p1.x, clipped_screen_p1.y);
-            glVertex2f(clipped_screen_p2.x, clipped_screen_p2.y);
-            glEnd();
-        }
-    }
-
-    // --- 4. Label Visible/Intersection Points on the Graph ---
-    for (size_t i = 0; i < visible_points.size(); ++i) {
-        const auto& p_logical = visible_points[i];
-        Point p_screen = logical_to_screen(p_logical.x, p_logical.y);
-
-        string label = "P" + to_string(i + 1);
-        // Draw the label near the point (offset by 8 units)
-        draw_text(p_screen.x + 8, p_screen.y + 8, 0.0f, 0.0f, 0.8f, label,
-                  GLUT_BITMAP_HELVETICA_12);
-    }
+    // 3. Draw the visible part of closed shapes, the Clipping Window and
+    // the Lines
+    draw_shape_fills();
+    draw_clipping_window();
+    draw_lod_frame();
+    glDisable(GL_SCISSOR_TEST);
 
-    // --- 5. Draw Coordinate List ---
+    // --- 4. Draw Coordinate List ---
 
     // Draw background for the list area
     glColor3f(0.95f, 0.95f, 0.95f);
@@ -413,7 +633,8 @@ void draw_line_input_mode() {
         ss << fixed << setprecision(1);
         ss << "Click P2 to connect to the previous point. P1: ("
            << current_line_start.x << ", " << current_line_start.y
-           << "). Press SPACE to start a new line.";
+           << "). Click the first point to close the shape, SPACE to start "
+              "a new line.";
         prompt = ss.str();
     }
 
@@ -489,7 +710,8 @@ void mouse(int button, int state, int x, int y) {
             if (ymin > ymax)
                 swap(ymin, ymax);
 
-            app_mode = LINE_INPUT_MODE;
+            // Back to the results when only the window was redefined
+            app_mode = lines_to_clip.empty() ? LINE_INPUT_MODE : CLIPPING_MODE;
             click_count = 0;
         }
     } else if (app_mode == LINE_INPUT_MODE) {
@@ -504,14 +726,29 @@ void mouse(int button, int state, int x, int y) {
 
         if (drawing_new_segment) {
             current_line_start = click_point_logical;
+            chain_start = click_point_logical;
+            chain_first_line = lines_to_clip.size();
             drawing_new_segment = false;
         } else {
+            // A click near the chain's first point closes the shape
+            Point first = logical_to_screen(chain_start.x, chain_start.y);
+            bool started = current_line_start.x != chain_start.x ||
+                           current_line_start.y != chain_start.y;
+            bool closes = started && fabs(screen_x - first.x) <= 6 &&
+                          fabs(screen_y - first.y) <= 6;
+
             LineSegment new_segment;
             new_segment.p1 = current_line_start;
-            new_segment.p2 = click_point_logical;
+            new_segment.p2 = closes ? chain_start : click_point_logical;
             lines_to_clip.push_back(new_segment);
+            ++lines_version;
 
-            current_line_start = click_point_logical;
+            current_line_start = new_segment.p2;
+            if (closes) {
+                closed_shapes.push_back(
+                    {chain_first_line, lines_to_clip.size()});
+                drawing_new_segment = true;
+            }
         }
     }
 
@@ -525,12 +762,37 @@ void keyboard(unsigned char key, int x, int y) {
         } else if (key == ' ') {
             drawing_new_segment = true;
         }
+    } else if (app_mode == CLIPPING_MODE && (key == 'w' || key == 'W')) {
+        // Redefine the clip window, keeping the lines
+        app_mode = WINDOW_INPUT_MODE;
+        click_count = 0;
+        zoom = 1.0f;
+        view_center = {0, 0};
+    } else if (app_mode == CLIPPING_MODE &&
+               (key == '+' || key == '=' || key == '-')) {
+        // Zoom in or out about the clip window's centre
+        zoom = key == '-' ? max(1.0f, zoom / 2) : min(256.0f, zoom * 2);
+        if (zoom > 1.0f)
+            view_center = {(xmin + xmax) / 2, (ymin + ymax) / 2};
+        else
+            view_center = {0, 0};
+    } else if (app_mode == CLIPPING_MODE && (key == 'h' || key == 'H')) {
+        window_shape = (window_shape + 1) % 3;
     } else if (key == 'r' || key == 'R') { // Reset everything
         app_mode = WINDOW_INPUT_MODE;
         click_count = 0;
         xmin = ymin = xmax = ymax = 0.0f;
+        window_shape = RECT_WINDOW;
+        zoom = 1.0f;
+        view_center = {0, 0};
         lines_to_clip.clear();
+        ++lines_version;
+        closed_shapes.clear();
         visible_points.clear();
+        segment_batch.clear();
+        segment_grid.clear();
+        clip_cache.invalidate();
+        convex_shape = -1;
         drawing_new_segment = true;
     }
     glutPostRedisplay();
@@ -0,0 +1,87 @@
+#ifndef COMMON_BRUSH_LINE_H
+#define COMMON_BRUSH_LINE_H
+
+// Bold lines as the Minkowski sum of a Bresenham path and a brush.
+// Instead of stamping the whole brush at every step (a 3x3 brush writes most
+// pixels 3-6 times), each row keeps only its leftmost and rightmost covered
+// pixel. The path is 8-connected and monotone and the brush is convex, so
+// every row of the sum is a single run. It is emitted as one span, and every
+// covered pixel is written exactly once.
+
+#include "framebuffer.h"
+#include "line_kernels.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+enum BrushShape { BRUSH_SQUARE, BRUSH_ROUND };
+
+struct BrushStroke {
+    int radius = 1;
+    BrushShape shape = BRUSH_SQUARE;
+    std::vector<int> halfWidth; // Brush half-width for rows -radius..radius
+    int yBase = 0;
+    std::vector<int> minX, maxX; // Covered run per row, from yBase upwards
+
+    BrushStroke(int r = 1, BrushShape s = BRUSH_SQUARE) { setBrush(r, s); }
+
+    void setBrush(int r, BrushShape s) {
+        radius = r < 0 ? 0 : r;
+        shape = s;
+        halfWidth.assign(2 * radius + 1, radius);
+        if (shape == BRUSH_ROUND) {
+            // Digital disc x^2 + y^2 <= r^2 + r, which looks rounder than
+            // r^2 at small sizes
+            for (int dy = -radius; dy <= radius; ++dy)
+                halfWidth[dy + radius] =
+                    (int)std::sqrt((double)(radius * radius + radius - dy * dy));
+        }
+    }
+
+    // Prepares rows for a path whose points stay within [yLo, yHi].
+    void reset(int yLo, int yHi) {
+        yBase = yLo - radius;
+        int rows = yHi - yLo + 2 * radius + 1;
+        minX.assign(rows, INT_MAX);
+        maxX.assign(rows, INT_MIN);
+    }
+
+    // O(brush height) per path point, not O(brush area).
+    void addPoint(int x, int y) {
+        int base = y - radius - yBase;
+        for (int i = 0; i <= 2 * radius; ++i) {
+            int hw = halfWidth[i];
+            if (x - hw < minX[base + i])
+                minX[base + i] = x - hw;
+            if (x + hw > maxX[base + i])
+                maxX[base + i] = x + hw;
+        }
+    }
+
+    // Calls emit(y, xLeft, xRight) once per covered row.
+    template <class SpanFn> void emitSpans(SpanFn emit) const {
+        for (size_t i = 0; i < minX.size(); ++i)
+            if (minX[i] <= maxX[i])
+                emit(yBase + (int)i, minX[i], maxX[i]);
+    }
+};
+
+// Bresenham path from (x1, y1) to (x2, y2) swept by the stroke's brush.
+template <class SpanFn>
+void brushLineSpans(BrushStroke& stroke, int x1, int y1, int x2, int y2,
+                    SpanFn emit) {
+    stroke.reset(std::min(y1, y2), std::max(y1, y2));
+    bresenhamLine(x1, y1, x2, y2,
+                  [&](int x, int y) { stroke.addPoint(x, y); });
+    stroke.emitSpans(emit);
+}
+
+inline void drawBrushLine(Framebuffer& fb, BrushStroke& stroke, int x1, int y1,
+                          int x2, int y2) {
+    brushLineSpans(stroke, x1, y1, x2, y2,
+                   [&](int y, int xa, int xb) { fb.fillSpan(y, xa, xb); });
+}
+
+#endif // COMMON_BRUSH_LINE_H
@@ -0,0 +1,169 @@
+#ifndef COMMON_CCL_H
+#define COMMON_CCL_H
+
+// Connected-component labelling of a Framebuffer: every 4-connected region
+// of one colour gets a label, and each label keeps the list of runs that
+// make it up. Filling a region afterwards is a lookup plus one span per
+// run, with no traversal.
+//
+// Labelling works on horizontal runs instead of pixels. Rows are split into
+// strips. Each thread extracts the runs of its strip and unions runs that
+// touch the row below within the strip; the strips only share the rows at
+// their seams, which are merged afterwards on one thread. Every union links
+// the larger root to the smaller one, so a run's parent never has a larger
+// index and the final flattening is a single ascending pass.
+
+#include "framebuffer.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <vector>
+
+struct PixelRun {
+    int y, x0, x1;
+    uint32_t color;
+};
+
+class RegionLabels {
+  public:
+    void build(const Framebuffer& fb, ThreadPool& pool = defaultThreadPool()) {
+        width = fb.width;
+        height = fb.height;
+        int strips = std::max(1, std::min((int)pool.size() * 4, height));
+        std::vector<int> stripRow(strips + 1);
+        for (int s = 0; s <= strips; ++s)
+            stripRow[s] = (int)((long long)height * s / strips);
+
+        // Runs per row, then their offsets, then the runs themselves.
+        rowStart.assign(height + 1, 0);
+        pool.parallelFor(strips, [&](int s) {
+            for (int y = stripRow[s]; y < stripRow[s + 1]; ++y) {
+                const uint32_t* row = fb.row(y);
+                int n = 1;
+                for (int x = 1; x < width; ++x)
+                    n += row[x] != row[x - 1];
+                rowStart[y + 1] = n;
+            }
+        });
+        for (int y = 0; y < height; ++y)
+            rowStart[y + 1] += rowStart[y];
+        runs.resize(rowStart[height]);
+        parent.resize(runs.size());
+        pool.parallelFor(strips, [&](int s) {
+            for (int y = stripRow[s]; y < stripRow[s + 1]; ++y) {
+                const uint32_t* row = fb.row(y);
+                int i = rowStart[y], x0 = 0;
+                for (int x = 1; x <= width; ++x) {
+                    if (x == width || row[x] != row[x0]) {
+                        runs[i] = {y, x0, x - 1, row[x0]};
+                        parent[i] = i;
+                        ++i;
+                        x0 = x;
+                    }
+                }
+                if (y > stripRow[s])
+                    unionRows(y);
+            }
+        });
+        for (int s = 1; s < strips; ++s)
+            unionRows(stripRow[s]);
+
+        // Parents only point down, so roots are final by the time we get to
+        // a run's parent.
+        runLabel.resize(runs.size());
+        count = 0;
+        for (size_t i = 0; i < runs.size(); ++i) {
+            int p = parent[parent[i]];
+            parent[i] = p;
+            runLabel[i] = (p == (int)i) ? count++ : runLabel[p];
+        }
+
+        // Group the runs by label (counting sort).
+        labelStart.assign(count + 1, 0);
+        for (int l : runLabel)
+            ++labelStart[l + 1];
+        for (int l = 0; l < count; ++l)
+            labelStart[l + 1] += labelStart[l];
+        labelRuns.resize(runs.size());
+        std::vector<int> fillPos(labelStart.begin(), labelStart.end() - 1);
+        for (size_t i = 0; i < runs.size(); ++i)
+            labelRuns[fillPos[runLabel[i]]++] = (int)i;
+    }
+
+    int regionCount() const { return count; }
+
+    // Label of the region containing (x, y), or -1 outside the image.
+    int labelAt(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height)
+            return -1;
+        auto first = runs.begin() + rowStart[y];
+        auto last = runs.begin() + rowStart[y + 1];
+        auto it = std::upper_bound(first, last, x, [](int v, const PixelRun& r) {
+            return v < r.x0;
+        });
+        return runLabel[(it - 1) - runs.begin()];
+    }
+
+    uint32_t regionColor(int label) const {
+        return runs[labelRuns[labelStart[label]]].color;
+    }
+
+    long long regionSize(int label) const {
+        long long n = 0;
+        for (int i = labelStart[label]; i < labelStart[label + 1]; ++i)
+            n += runs[labelRuns[i]].x1 - runs[labelRuns[i]].x0 + 1;
+        return n;
+    }
+
+    // Calls emit(y, xLeft, xRight) for every run of the region.
+    template <class SpanFn> void forEachSpan(int label, SpanFn emit) const {
+        for (int i = labelStart[label]; i < labelStart[label + 1]; ++i) {
+            const PixelRun& r = runs[labelRuns[i]];
+            emit(r.y, r.x0, r.x1);
+        }
+    }
+
+  private:
+    int find(int i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]]; // Path halving
+            i = parent[i];
+        }
+        return i;
+    }
+
+    void unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a < b)
+            parent[b] = a;
+        else if (b < a)
+            parent[a] = b;
+    }
+
+    // Unions the runs of row y with same-coloured overlapping runs of y - 1.
+    void unionRows(int y) {
+        int i = rowStart[y], iEnd = rowStart[y + 1];
+        int j = rowStart[y - 1], jEnd = rowStart[y];
+        while (i < iEnd && j < jEnd) {
+            const PixelRun& a = runs[i];
+            const PixelRun& b = runs[j];
+            if (a.color == b.color && a.x0 <= b.x1 && b.x0 <= a.x1)
+                unite(i, j);
+            if (a.x1 < b.x1)
+                ++i;
+            else
+                ++j;
+        }
+    }
+
+    int width = 0, height = 0, count = 0;
+    std::vector<PixelRun> runs;  // Row by row, left to right
+    std::vector<int> rowStart;   // Runs of row y: rowStart[y]..rowStart[y+1]
+    std::vector<int> parent;     // Union-find over run indices
+    std::vector<int> runLabel;   // Compact label of each run
+    std::vector<int> labelStart; // Runs of label l: labelRuns[labelStart[l]..]
+    std::vector<int> labelRuns;
+};
+
+#endif // COMMON_CCL_H
@@ -0,0 +1,72 @@
+#ifndef COMMON_CIRCLE_CACHE_H
+#define COMMON_CIRCLE_CACHE_H
+
+// Unit-circle tables keyed by segment count. A polygonal circle is then the
+// table scaled by r and offset by the centre, so drawing one costs two
+// multiply-adds per vertex and no cosf / sinf. Tables are built the first
+// time a segment count is asked for and kept for the life of the program.
+
+#include <cmath>
+#include <vector>
+
+// cos / sin of i * 2pi / segments for i = 0..segments, as x, y pairs. The
+// last pair repeats the first exactly, so fans and strips close without a
+// seam. The pointer stays valid for the life of the program.
+inline const float* unitCircle(int segments) {
+    static std::vector<std::vector<float>> tables; // Indexed by segments
+    if (segments < 3)
+        segments = 3;
+    if ((int)tables.size() <= segments)
+        tables.resize(segments + 1);
+    std::vector<float>& t = tables[segments];
+    if (t.empty()) {
+        t.resize(2 * (segments + 1));
+        const double step = 2.0 * 3.14159265358979323846 / segments;
+        for (int i = 0; i < segments; ++i) {
+            t[2 * i] = (float)std::cos(i * step);
+            t[2 * i + 1] = (float)std::sin(i * step);
+        }
+        t[2 * segments] = t[0];
+        t[2 * segments + 1] = t[1];
+    }
+    return t.data();
+}
+
+// Triangle fan for a filled circle: the centre, then segments + 1 rim
+// points. Returns the number of vertices written to `out`.
+inline int circleFanVertices(std::vector<float>& out, float cx, float cy,
+                             float r, int segments) {
+    if (segments < 3)
+        segments = 3;
+    const float* u = unitCircle(segments);
+    out.resize(2 * (segments + 2));
+    float* v = out.data();
+    v[0] = cx;
+    v[1] = cy;
+    for (int i = 0; i <= segments; ++i) {
+        v[2 * i + 2] = cx + u[2 * i] * r;
+        v[2 * i + 3] = cy + u[2 * i + 1] * r;
+    }
+    return segments + 2;
+}
+
+// Triangle strip for a ring between rInner and rOuter, alternating inner and
+// outer rim points. Returns the number of vertices written to `out`.
+inline int ringStripVertices(std::vector<float>& out, float cx, float cy,
+                             float rInner, float rOuter, int segments) {
+    if (segments < 3)
+        segments = 3;
+    const float* u = unitCircle(segments);
+    out.resize(4 * (segments + 1));
+    float* v = out.data();
+    for (int i = 0; i <= segments; ++i) {
+        float c = u[2 * i], s = u[2 * i + 1];
+        v[4 * i] = cx + c * rInner;
+        v[4 * i + 1] = cy + s * rInner;
+        v[4 * i + 2] = cx + c * rOuter;
+        v[4 * i + 3] = cy + s * rOuter;
+    }
+    return 2 * (segments + 1);
+}
+
+#endif // COMMON_CIRCLE_CACHE_H
@@ -0,0 +1,39 @@
+#ifndef COMMON_CIRCLE_CACHE_GL_H
+#define COMMON_CIRCLE_CACHE_GL_H
+
+// Draws cached circles (circle_cache.h) with one glDrawArrays each, using
+// the current glColor.
+
+#include "circle_cache.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#ifdef __APPLE__
+#include <GLUT/glut.h>
+#else
+#include <GL/glut.h>
+#endif
+
+inline void drawCircleVertices(GLenum mode, const std::vector<float>& v,
+                               int count) {
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, v.data());
+    glDrawArrays(mode, 0, count);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+inline void drawCachedCircle(float cx, float cy, float r, int segments) {
+    static std::vector<float> verts; // Reused, so no per-call allocation
+    int n = circleFanVertices(verts, cx, cy, r, segments);
+    drawCircleVertices(GL_TRIANGLE_FAN, verts, n);
+}
+
+inline void drawCachedRing(float cx, float cy, float rInner, float rOuter,
+                           int segments) {
+    static std::vector<float> verts;
+    int n = ringStripVertices(verts, cx, cy, rInner, rOuter, segments);
+    drawCircleVertices(GL_TRIANGLE_STRIP, verts, n);
+}
+
+#endif // COMMON_CIRCLE_CACHE_GL_H
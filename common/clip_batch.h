@@ -0,0 +1,290 @@
+#ifndef COMMON_CLIP_BATCH_H
+#define COMMON_CLIP_BATCH_H
+
+// Liang-Barsky line clipping against an axis-aligned window, for one
+// segment or for whole batches. Batches are stored as structure of arrays
+// so a vector register holds the same coordinate of 4 (SSE2) or 8 (AVX)
+// segments. The four boundary tests become min / max and compare masks
+// instead of branches, and every segment yields its parameter interval
+// t0..t1 plus one bit of an accept mask.
+//
+// The batch gives the same results as liangBarsky() bit for bit, down to
+// the sign of zero. It divides instead of multiplying by a reciprocal,
+// computes each boundary's t with the scalar formula, uses the same
+// threshold for parallel edges (|d| < 1e-6) and passes min / max their
+// operands in std::min / std::max order.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define COMMON_CLIP_SSE2 1
+#endif
+#if defined(__AVX__)
+#include <immintrin.h>
+#define COMMON_CLIP_AVX 1
+#endif
+
+struct ClipWindow {
+    float xmin, ymin, xmax, ymax;
+};
+
+// Segments (x0[i], y0[i]) -> (x1[i], y1[i]).
+struct SegmentSoA {
+    std::vector<float> x0, y0, x1, y1;
+
+    size_t size() const { return x0.size(); }
+    void clear() {
+        x0.clear();
+        y0.clear();
+        x1.clear();
+        y1.clear();
+    }
+    void push(float ax, float ay, float bx, float by) {
+        x0.push_back(ax);
+        y0.push_back(ay);
+        x1.push_back(bx);
+        y1.push_back(by);
+    }
+};
+
+// Per segment: the visible part is t0..t1 of the way from p0 to p1, valid
+// when the segment's bit is set in `accept` (64 segments per word).
+struct ClipIntervals {
+    std::vector<float> t0, t1;
+    std::vector<uint64_t> accept;
+
+    bool accepted(size_t i) const { return (accept[i >> 6] >> (i & 63)) & 1; }
+
+    // Number of accepted segments before index `end`.
+    size_t acceptedBefore(size_t end) const {
+        size_t n = 0;
+        for (size_t w = 0; w < end >> 6; ++w)
+            n += __builtin_popcountll(accept[w]);
+        if (end & 63)
+            n += __builtin_popcountll(accept[end >> 6] &
+                                      ((1ull << (end & 63)) - 1));
+        return n;
+    }
+
+    // Calls fn(i) for every accepted segment, in order.
+    template <class Fn> void forEachAccepted(Fn fn) const {
+        for (size_t w = 0; w < accept.size(); ++w)
+            for (uint64_t m = accept[w]; m; m &= m - 1)
+                fn((w << 6) + __builtin_ctzll(m));
+    }
+};
+
+// Accepted segments only: segment id[k] is visible from t0[k] to t1[k].
+struct ClippedSegments {
+    std::vector<uint32_t> id;
+    std::vector<float> t0, t1;
+
+    void clear() {
+        id.clear();
+        t0.clear();
+        t1.clear();
+    }
+};
+
+// Clips one segment. Returns false when no part of it is inside.
+inline bool liangBarsky(float x0, float y0, float x1, float y1,
+                        const ClipWindow& w, float& t0, float& t1) {
+    float dx = x1 - x0, dy = y1 - y0;
+    float p[4] = {-dx, dx, -dy, dy};
+    float q[4] = {x0 - w.xmin, w.xmax - x0, y0 - w.ymin, w.ymax - y0};
+    float a = 0.0f, b = 1.0f;
+    for (int i = 0; i < 4; ++i) {
+        if (std::fabs(p[i]) < 1e-6) {
+            if (q[i] < 0.0f)
+                return false;
+        } else {
+            float t = q[i] / p[i];
+            if (p[i] < 0.0f)
+                a = std::max(a, t);
+            else
+                b = std::min(b, t);
+        }
+    }
+    if (a > b)
+        return false;
+    t0 = a;
+    t1 = b;
+    return true;
+}
+
+// Lanes of one axis: (p - lo) / -d and (hi - p) / d, as liangBarsky()
+// computes them, picked as the entry and exit parameter by the sign of d,
+// or the whole line when d is ~0 and p is inside. |d| <= 1e-6f is the
+// float form of the scalar |d| < 1e-6 (double). std::max(a, t) keeps a
+// unless t > a, which is _mm_max_ps(t, a); likewise for min.
+#ifdef COMMON_CLIP_AVX
+inline void clipAxis8(__m256 p, __m256 d, __m256 lo, __m256 hi, __m256& t0,
+                      __m256& t1, __m256& reject) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 parallel = _mm256_cmp_ps(_mm256_and_ps(d, absMask),
+                                    _mm256_set1_ps(1e-6f), _CMP_LE_OQ);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 ta = _mm256_div_ps(_mm256_sub_ps(p, lo), _mm256_xor_ps(d, signMask));
+    __m256 tb = _mm256_div_ps(_mm256_sub_ps(hi, p), d);
+    __m256 backward = _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_LT_OQ);
+    __m256 enter = _mm256_blendv_ps(ta, tb, backward);
+    __m256 exit = _mm256_blendv_ps(tb, ta, backward);
+    enter = _mm256_blendv_ps(enter, t0, parallel);
+    exit = _mm256_blendv_ps(exit, t1, parallel);
+    t0 = _mm256_max_ps(enter, t0);
+    t1 = _mm256_min_ps(exit, t1);
+    __m256 outside = _mm256_or_ps(_mm256_cmp_ps(p, lo, _CMP_LT_OQ),
+                                  _mm256_cmp_ps(p, hi, _CMP_GT_OQ));
+    reject = _mm256_or_ps(reject, _mm256_and_ps(parallel, outside));
+}
+#endif
+
+#ifdef COMMON_CLIP_SSE2
+inline __m128 select4(__m128 mask, __m128 a, __m128 b) { // mask ? a : b
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+inline void clipAxis4(__m128 p, __m128 d, __m128 lo, __m128 hi, __m128& t0,
+                      __m128& t1, __m128& reject) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 parallel = _mm_cmple_ps(_mm_and_ps(d, absMask), _mm_set1_ps(1e-6f));
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 ta = _mm_div_ps(_mm_sub_ps(p, lo), _mm_xor_ps(d, signMask));
+    __m128 tb = _mm_div_ps(_mm_sub_ps(hi, p), d);
+    __m128 backward = _mm_cmplt_ps(d, _mm_setzero_ps());
+    __m128 enter = select4(parallel, t0, select4(backward, tb, ta));
+    __m128 exit = select4(parallel, t1, select4(backward, ta, tb));
+    t0 = _mm_max_ps(enter, t0);
+    t1 = _mm_min_ps(exit, t1);
+    __m128 outside = _mm_or_ps(_mm_cmplt_ps(p, lo), _mm_cmpgt_ps(p, hi));
+    reject = _mm_or_ps(reject, _mm_and_ps(parallel, outside));
+}
+#endif
+
+// Clips n segments given as arrays. t0 / t1 receive n values each (only
+// meaningful for accepted segments) and `accept` (n + 63) / 64 words.
+inline void liangBarskyBatch(const float* x0, const float* y0,
+                             const float* x1, const float* y1, size_t n,
+                             const ClipWindow& w, float* t0, float* t1,
+                             uint64_t* accept) {
+    for (size_t i = 0; i < (n + 63) / 64; ++i)
+        accept[i] = 0;
+    size_t i = 0;
+#if defined(COMMON_CLIP_AVX)
+    const __m256 xmin = _mm256_set1_ps(w.xmin), xmax = _mm256_set1_ps(w.xmax);
+    const __m256 ymin = _mm256_set1_ps(w.ymin), ymax = _mm256_set1_ps(w.ymax);
+    for (; i + 8 <= n; i += 8) {
+        __m256 px = _mm256_loadu_ps(x0 + i), py = _mm256_loadu_ps(y0 + i);
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x1 + i), px);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y1 + i), py);
+        __m256 a = _mm256_setzero_ps(), b = _mm256_set1_ps(1.0f);
+        __m256 reject = _mm256_setzero_ps();
+        clipAxis8(px, dx, xmin, xmax, a, b, reject);
+        clipAxis8(py, dy, ymin, ymax, a, b, reject);
+        reject = _mm256_or_ps(reject, _mm256_cmp_ps(a, b, _CMP_GT_OQ));
+        _mm256_storeu_ps(t0 + i, a);
+        _mm256_storeu_ps(t1 + i, b);
+        uint64_t bits = (uint64_t)(~_mm256_movemask_ps(reject) & 0xFF);
+        accept[i >> 6] |= bits << (i & 63);
+    }
+#elif defined(COMMON_CLIP_SSE2)
+    const __m128 xmin = _mm_set1_ps(w.xmin), xmax = _mm_set1_ps(w.xmax);
+    const __m128 ymin = _mm_set1_ps(w.ymin), ymax = _mm_set1_ps(w.ymax);
+    for (; i + 4 <= n; i += 4) {
+        __m128 px = _mm_loadu_ps(x0 + i), py = _mm_loadu_ps(y0 + i);
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x1 + i), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y1 + i), py);
+        __m128 a = _mm_setzero_ps(), b = _mm_set1_ps(1.0f);
+        __m128 reject = _mm_setzero_ps();
+        clipAxis4(px, dx, xmin, xmax, a, b, reject);
+        clipAxis4(py, dy, ymin, ymax, a, b, reject);
+        reject = _mm_or_ps(reject, _mm_cmpgt_ps(a, b));
+        _mm_storeu_ps(t0 + i, a);
+        _mm_storeu_ps(t1 + i, b);
+        uint64_t bits = (uint64_t)(~_mm_movemask_ps(reject) & 0xF);
+        accept[i >> 6] |= bits << (i & 63);
+    }
+#endif
+    for (; i < n; ++i) {
+        if (liangBarsky(x0[i], y0[i], x1[i], y1[i], w, t0[i], t1[i]))
+            accept[i >> 6] |= 1ull << (i & 63);
+    }
+}
+
+inline void liangBarskyBatch(const SegmentSoA& s, const ClipWindow& w,
+                             ClipIntervals& out) {
+    size_t n = s.size();
+    out.t0.resize(n);
+    out.t1.resize(n);
+    out.accept.resize((n + 63) / 64);
+    liangBarskyBatch(s.x0.data(), s.y0.data(), s.x1.data(), s.y1.data(), n,
+                     w, out.t0.data(), out.t1.data(), out.accept.data());
+}
+
+// Clip results for a list of segments that only grows, cached by segment
+// index. update() clips just the segments appended since the previous call
+// (plus the rest of the last, partly filled accept word); a different
+// window, a shorter list or invalidate() clips everything again.
+class IncrementalClipper {
+  public:
+    // Brings the results up to date with `s` and `w`. Returns the index of
+    // the first segment whose result is new; earlier ones are unchanged.
+    size_t update(const SegmentSoA& s, const ClipWindow& w) {
+        if (!clippedAgainst(w) || s.size() < done) {
+            done = 0;
+            window = w;
+            valid = true;
+        }
+        size_t n = s.size(), changed = done;
+        size_t first = done & ~(size_t)63; // Start of a whole accept word
+        out.t0.resize(n);
+        out.t1.resize(n);
+        out.accept.resize((n + 63) / 64);
+        if (first < n)
+            liangBarskyBatch(s.x0.data() + first, s.y0.data() + first,
+                             s.x1.data() + first, s.y1.data() + first,
+                             n - first, w, out.t0.data() + first,
+                             out.t1.data() + first,
+                             out.accept.data() + first / 64);
+        done = n;
+        return changed;
+    }
+
+    // Replaces every result with `c`, the accepted ones among n segments
+    // clipped against w by other means (e.g. SegmentGrid).
+    void assign(size_t n, const ClipWindow& w, const ClippedSegments& c) {
+        out.t0.resize(n);
+        out.t1.resize(n);
+        out.accept.assign((n + 63) / 64, 0);
+        for (size_t k = 0; k < c.id.size(); ++k) {
+            uint32_t i = c.id[k];
+            out.t0[i] = c.t0[k];
+            out.t1[i] = c.t1[k];
+            out.accept[i >> 6] |= 1ull << (i & 63);
+        }
+        window = w;
+        valid = true;
+        done = n;
+    }
+
+    bool clippedAgainst(const ClipWindow& w) const {
+        return valid && w.xmin == window.xmin && w.ymin == window.ymin &&
+               w.xmax == window.xmax && w.ymax == window.ymax;
+    }
+
+    void invalidate() { valid = false; }
+    const ClipIntervals& result() const { return out; }
+
+  private:
+    ClipWindow window = {0, 0, 0, 0};
+    bool valid = false;
+    size_t done = 0; // Segments with a cached result
+    ClipIntervals out;
+};
+
+#endif // COMMON_CLIP_BATCH_H
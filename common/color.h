@@ -0,0 +1,67 @@
+#ifndef COMMON_COLOR_H
+#define COMMON_COLOR_H
+
+// Colour model conversions shared by the labs (moved here from
+// assignment/task_2.cpp so the fill shaders can use it too).
+
+#include <cmath>
+
+/**
+ * @brief Converts HSV to RGB color model.
+ * @param h Hue (0-360 degrees)
+ * @param s Saturation (0-1)
+ * @param v Value (0-1)
+ * @param r Pointer to store Red component (0-1)
+ * @param g Pointer to store Green component (0-1)
+ * @param b Pointer to store Blue component (0-1)
+ */
+inline void hsvToRgb(float h, float s, float v, float* r, float* g, float* b) {
+    if (s == 0.0f) {
+        *r = *g = *b = v;
+        return;
+    }
+
+    // Normalize H to [0, 6)
+    float h_norm = h / 60.0f;
+    int i = (int)std::floor(h_norm);
+    float f = h_norm - i;
+
+    float p = v * (1.0f - s);
+    float q = v * (1.0f - s * f);
+    float t = v * (1.0f - s * (1.0f - f));
+
+    switch (i % 6) {
+    case 0:
+        *r = v;
+        *g = t;
+        *b = p;
+        break;
+    case 1:
+        *r = q;
+        *g = v;
+        *b = p;
+        break;
+    case 2:
+        *r = p;
+        *g = v;
+        *b = t;
+        break;
+    case 3:
+        *r = p;
+        *g = q;
+        *b = v;
+        break;
+    case 4:
+        *r = t;
+        *g = p;
+        *b = v;
+        break;
+    default: // 5
+        *r = v;
+        *g = p;
+        *b = q;
+        break;
+    }
+}
+
+#endif // COMMON_COLOR_H
@@ -0,0 +1,211 @@
+#ifndef COMMON_CONVEX_CLIP_H
+#define COMMON_CONVEX_CLIP_H
+
+// Cyrus-Beck line clipping against any convex polygon (rotated rectangles,
+// hexagons, ...). When the window is built, each edge gets an inward unit
+// normal, and edges with opposite normals are paired into slabs
+// lo <= n.p <= hi. Clipping against a slab is then exactly the Liang-Barsky
+// step along one axis, on the coordinate projected onto n. A rectangle is
+// two slabs, as is a rotated one, and a regular hexagon is three. An
+// unpaired edge is a slab with hi = +inf. Batches reuse clipAxis4/8 and the
+// SegmentSoA / ClipIntervals types of clip_batch.h.
+//
+// For ConvexWindow::rectangle() the normals are the axes and the results
+// equal liangBarsky() bit for bit. The batch equals cyrusBeck() bit for bit
+// as long as the compiler does not fuse the scalar multiply-adds (no -mfma).
+
+#include "clip_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Inside when lo[i] <= nx[i] * x + ny[i] * y <= hi[i] for every slab i.
+struct ConvexWindow {
+    std::vector<float> nx, ny, lo, hi;
+    std::vector<float> xs, ys; // Vertices counter-clockwise, for drawing
+
+    ConvexWindow() = default;
+
+    // Vertices of a convex polygon in either winding. Repeated vertices
+    // are skipped.
+    ConvexWindow(const float* px, const float* py, int n) {
+        double area = 0;
+        for (int i = 0; i < n; ++i) {
+            int j = (i + 1) % n;
+            area += (double)px[i] * py[j] - (double)px[j] * py[i];
+        }
+        for (int k = 0; k < n; ++k) {
+            int i = area >= 0 ? k : n - 1 - k;
+            xs.push_back(px[i]);
+            ys.push_back(py[i]);
+        }
+        // Inward normal and offset of every edge: inside when n.p >= c.
+        std::vector<float> ex, ey, ec;
+        for (int i = 0; i < n; ++i) {
+            int j = (i + 1) % n;
+            float dx = xs[j] - xs[i], dy = ys[j] - ys[i];
+            float len = std::sqrt(dx * dx + dy * dy);
+            if (len == 0.0f)
+                continue;
+            ex.push_back(-dy / len);
+            ey.push_back(dx / len);
+            ec.push_back(ex.back() * xs[i] + ey.back() * ys[i]);
+        }
+        std::vector<bool> used(ex.size(), false);
+        for (size_t i = 0; i < ex.size(); ++i) {
+            if (used[i])
+                continue;
+            float top = INFINITY;
+            for (size_t j = i + 1; j < ex.size(); ++j) {
+                if (!used[j] && std::fabs(ex[i] + ex[j]) < 1e-5f &&
+                    std::fabs(ey[i] + ey[j]) < 1e-5f) {
+                    used[j] = true;
+                    top = -ec[j];
+                    break;
+                }
+            }
+            nx.push_back(ex[i]);
+            ny.push_back(ey[i]);
+            lo.push_back(ec[i]);
+            hi.push_back(top);
+        }
+    }
+
+    static ConvexWindow rectangle(const ClipWindow& w) {
+        float px[4] = {w.xmin, w.xmax, w.xmax, w.xmin};
+        float py[4] = {w.ymin, w.ymin, w.ymax, w.ymax};
+        return ConvexWindow(px, py, 4);
+    }
+
+    // Rectangle of half-size hw x hh centred on (cx, cy), turned by
+    // `angle` radians counter-clockwise.
+    static ConvexWindow rotated(float cx, float cy, float hw, float hh,
+                                float angle) {
+        float cs = std::cos(angle), sn = std::sin(angle);
+        float px[4], py[4];
+        const float sx[4] = {-1, 1, 1, -1}, sy[4] = {-1, -1, 1, 1};
+        for (int i = 0; i < 4; ++i) {
+            px[i] = cx + sx[i] * hw * cs - sy[i] * hh * sn;
+            py[i] = cy + sx[i] * hw * sn + sy[i] * hh * cs;
+        }
+        return ConvexWindow(px, py, 4);
+    }
+
+    // `sides` vertices on the ellipse of radii rx, ry around (cx, cy), the
+    // first one at `angle` radians.
+    static ConvexWindow regular(float cx, float cy, float rx, float ry,
+                                int sides, float angle = 0.0f) {
+        std::vector<float> px(sides), py(sides);
+        for (int i = 0; i < sides; ++i) {
+            double a = angle + 2 * M_PI * i / sides;
+            px[i] = cx + rx * (float)std::cos(a);
+            py[i] = cy + ry * (float)std::sin(a);
+        }
+        return ConvexWindow(px.data(), py.data(), sides);
+    }
+
+    size_t slabs() const { return lo.size(); }
+};
+
+// Clips one segment. Returns false when no part of it is inside.
+inline bool cyrusBeck(float x0, float y0, float x1, float y1,
+                      const ConvexWindow& w, float& t0, float& t1) {
+    float dx = x1 - x0, dy = y1 - y0;
+    float a = 0.0f, b = 1.0f;
+    for (size_t k = 0; k < w.slabs(); ++k) {
+        // liangBarsky() along the slab normal
+        float p0 = w.nx[k] * x0 + w.ny[k] * y0;
+        float d = w.nx[k] * dx + w.ny[k] * dy;
+        float p[2] = {-d, d};
+        float q[2] = {p0 - w.lo[k], w.hi[k] - p0};
+        for (int i = 0; i < 2; ++i) {
+            if (std::fabs(p[i]) < 1e-6) {
+                if (q[i] < 0.0f)
+                    return false;
+            } else {
+                float t = q[i] / p[i];
+                if (p[i] < 0.0f)
+                    a = std::max(a, t);
+                else
+                    b = std::min(b, t);
+            }
+        }
+    }
+    if (a > b)
+        return false;
+    t0 = a;
+    t1 = b;
+    return true;
+}
+
+// Clips n segments given as arrays; outputs as in liangBarskyBatch().
+inline void cyrusBeckBatch(const float* x0, const float* y0, const float* x1,
+                           const float* y1, size_t n, const ConvexWindow& w,
+                           float* t0, float* t1, uint64_t* accept) {
+    for (size_t i = 0; i < (n + 63) / 64; ++i)
+        accept[i] = 0;
+    const size_t slabs = w.slabs();
+    size_t i = 0;
+#if defined(COMMON_CLIP_AVX)
+    for (; i + 8 <= n; i += 8) {
+        __m256 px = _mm256_loadu_ps(x0 + i), py = _mm256_loadu_ps(y0 + i);
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x1 + i), px);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y1 + i), py);
+        __m256 a = _mm256_setzero_ps(), b = _mm256_set1_ps(1.0f);
+        __m256 reject = _mm256_setzero_ps();
+        for (size_t k = 0; k < slabs; ++k) {
+            __m256 nx = _mm256_set1_ps(w.nx[k]), ny = _mm256_set1_ps(w.ny[k]);
+            clipAxis8(_mm256_add_ps(_mm256_mul_ps(nx, px),
+                                    _mm256_mul_ps(ny, py)),
+                      _mm256_add_ps(_mm256_mul_ps(nx, dx),
+                                    _mm256_mul_ps(ny, dy)),
+                      _mm256_set1_ps(w.lo[k]), _mm256_set1_ps(w.hi[k]), a, b,
+                      reject);
+        }
+        reject = _mm256_or_ps(reject, _mm256_cmp_ps(a, b, _CMP_GT_OQ));
+        _mm256_storeu_ps(t0 + i, a);
+        _mm256_storeu_ps(t1 + i, b);
+        uint64_t bits = (uint64_t)(~_mm256_movemask_ps(reject) & 0xFF);
+        accept[i >> 6] |= bits << (i & 63);
+    }
+#elif defined(COMMON_CLIP_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        __m128 px = _mm_loadu_ps(x0 + i), py = _mm_loadu_ps(y0 + i);
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x1 + i), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y1 + i), py);
+        __m128 a = _mm_setzero_ps(), b = _mm_set1_ps(1.0f);
+        __m128 reject = _mm_setzero_ps();
+        for (size_t k = 0; k < slabs; ++k) {
+            __m128 nx = _mm_set1_ps(w.nx[k]), ny = _mm_set1_ps(w.ny[k]);
+            clipAxis4(_mm_add_ps(_mm_mul_ps(nx, px), _mm_mul_ps(ny, py)),
+                      _mm_add_ps(_mm_mul_ps(nx, dx), _mm_mul_ps(ny, dy)),
+                      _mm_set1_ps(w.lo[k]), _mm_set1_ps(w.hi[k]), a, b,
+                      reject);
+        }
+        reject = _mm_or_ps(reject, _mm_cmpgt_ps(a, b));
+        _mm_storeu_ps(t0 + i, a);
+        _mm_storeu_ps(t1 + i, b);
+        uint64_t bits = (uint64_t)(~_mm_movemask_ps(reject) & 0xF);
+        accept[i >> 6] |= bits << (i & 63);
+    }
+#endif
+    for (; i < n; ++i) {
+        if (cyrusBeck(x0[i], y0[i], x1[i], y1[i], w, t0[i], t1[i]))
+            accept[i >> 6] |= 1ull << (i & 63);
+    }
+}
+
+inline void cyrusBeckBatch(const SegmentSoA& s, const ConvexWindow& w,
+                           ClipIntervals& out) {
+    size_t n = s.size();
+    out.t0.resize(n);
+    out.t1.resize(n);
+    out.accept.resize((n + 63) / 64);
+    cyrusBeckBatch(s.x0.data(), s.y0.data(), s.x1.data(), s.y1.data(), n, w,
+                   out.t0.data(), out.t1.data(), out.accept.data());
+}
+
+#endif // COMMON_CONVEX_CLIP_H
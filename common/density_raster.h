@@ -0,0 +1,101 @@
+#ifndef COMMON_DENSITY_RASTER_H
+#define COMMON_DENSITY_RASTER_H
+
+// Per-pixel counts of primitives that are too small, or too many, to draw
+// one by one, turned into a single image. A pixel's opacity grows with the
+// log of its count, so one segment is still visible while dense areas
+// saturate gradually. The cost of drawing is then one image whatever the
+// number of primitives; present it with presentFramebuffer()
+// (framebuffer_gl.h) with blending enabled.
+
+#include "clip_batch.h"
+#include "framebuffer.h"
+#include "line_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class DensityRaster {
+  public:
+    DensityRaster(int w, int h) : w(w), h(h), counts((size_t)w * h, 0) {
+        picture.resize(w, h);
+    }
+
+    void clear() {
+        if (total)
+            std::fill(counts.begin(), counts.end(), 0u);
+        total = 0;
+        densest = 0;
+        drawn = false;
+    }
+    bool empty() const { return total == 0; }
+    size_t size() const { return total; } // Primitives counted
+
+    // One primitive at (x, y), in pixels; outside the raster is dropped.
+    void add(float x, float y) {
+        if (x < 0.0f || y < 0.0f || x >= w || y >= h)
+            return;
+        bump((int)x, (int)y);
+    }
+
+    // One count on every pixel of the segment inside the raster.
+    void addLine(float x0, float y0, float x1, float y1) {
+        float t0, t1;
+        ClipWindow bounds = {0.0f, 0.0f, w - 0.5f, h - 0.5f};
+        if (!liangBarsky(x0, y0, x1, y1, bounds, t0, t1))
+            return;
+        float dx = x1 - x0, dy = y1 - y0;
+        bresenhamLine((int)(x0 + t0 * dx), (int)(y0 + t0 * dy),
+                      (int)(x0 + t1 * dx), (int)(y0 + t1 * dy),
+                      [this](int x, int y) { bump(x, y); });
+    }
+
+    // The counts drawn in `color`: transparent where empty, opaque at the
+    // densest pixel. Row 0 is the bottom row. Kept until the counts or the
+    // colour change, so presenting an unchanged raster is just the upload.
+    const Framebuffer& image(uint32_t color) {
+        uint32_t rgb = color & 0x00FFFFFFu;
+        if (drawn && rgb == drawnColor)
+            return picture;
+        drawn = true;
+        drawnColor = rgb;
+        // Opacity by count, from a visible minimum up to 255
+        std::vector<uint32_t>& lut = alphaByCount;
+        uint32_t top = std::min<uint32_t>(densest, LUT_SIZE - 1);
+        lut.resize(top + 1);
+        double scale = top > 1 ? 1.0 / std::log((double)top) : 0.0;
+        lut[0] = rgb;
+        for (uint32_t c = 1; c < lut.size(); ++c) {
+            int a = 96 + (int)(159 * std::log((double)c) * scale + 0.5);
+            lut[c] = rgb | (uint32_t)std::min(a, 255) << 24;
+        }
+        const uint32_t last = lut.back();
+        for (size_t i = 0; i < counts.size(); ++i)
+            picture.pixels[i] =
+                counts[i] < lut.size() ? lut[counts[i]] : last;
+        return picture;
+    }
+
+  private:
+    static const uint32_t LUT_SIZE = 4096; // Counts above share the top
+
+    void bump(int x, int y) {
+        uint32_t c = ++counts[(size_t)y * w + x];
+        densest = std::max(densest, c);
+        ++total;
+        drawn = false;
+    }
+
+    int w, h;
+    std::vector<uint32_t> counts;
+    size_t total = 0;
+    uint32_t densest = 0;
+    std::vector<uint32_t> alphaByCount;
+    Framebuffer picture;
+    bool drawn = false; // picture is up to date, in drawnColor
+    uint32_t drawnColor = 0;
+};
+
+#endif // COMMON_DENSITY_RASTER_H
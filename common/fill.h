@@ -0,0 +1,312 @@
+#ifndef COMMON_FILL_H
+#define COMMON_FILL_H
+
+// Scanline (span) flood fill on a Framebuffer. Instead of recursing once
+// per pixel, each step scans a whole run of matching pixels, paints it as
+// one span and queues the runs above and below it as seed spans on an
+// explicit stack. Each pixel is read a small constant number of times and
+// the stack depth is bounded by the number of pending runs, not pixels.
+
+#include "framebuffer.h"
+
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define COMMON_FILL_SSE2 1
+#endif
+
+// Pixel colour matching for run scanning. Pixels match the target when
+// every RGB channel is within `tolerance` of it (alpha is ignored); a
+// tolerance of 0 is an exact match.
+inline bool colorNear(uint32_t a, uint32_t b, int tolerance) {
+    for (int shift = 0; shift < 24; shift += 8) {
+        int d = (int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF);
+        if (d > tolerance || d < -tolerance)
+            return false;
+    }
+    return true;
+}
+
+// Last x >= start whose pixels start..x all match, given row[start] does.
+inline int runEndScalar(const uint32_t* row, int start, int width,
+                        uint32_t target, int tolerance) {
+    int x = start + 1;
+    while (x < width && colorNear(row[x], target, tolerance))
+        ++x;
+    return x - 1;
+}
+
+// First x <= start whose pixels x..start all match, given row[start] does.
+inline int runBeginScalar(const uint32_t* row, int start, uint32_t target,
+                          int tolerance) {
+    int x = start;
+    while (x > 0 && colorNear(row[x - 1], target, tolerance))
+        --x;
+    return x;
+}
+
+#ifdef COMMON_FILL_SSE2
+// 16-bit mask, 4 bits per pixel, set where the 4 pixels at p match.
+inline int matchMask4(const uint32_t* p, __m128i target, __m128i tol) {
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+    __m128i diff = _mm_or_si128(_mm_subs_epu8(v, target),
+                                _mm_subs_epu8(target, v));
+    __m128i over = _mm_subs_epu8(diff, tol); // Non-zero past the tolerance
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(over, _mm_setzero_si128()));
+}
+
+// Tolerance in R, G and B; 255 in alpha so alpha never fails the test.
+inline __m128i toleranceVector(int tolerance) {
+    uint32_t t = (uint32_t)tolerance;
+    return _mm_set1_epi32((int)(t | (t << 8) | (t << 16) | 0xFF000000u));
+}
+#endif
+
+// SSE2 versions test 4 pixels per compare, 16 per loop iteration, and fall
+// back to the scalar loop for the last few pixels of the row.
+inline int runEnd(const uint32_t* row, int start, int width, uint32_t target,
+                  int tolerance) {
+#ifdef COMMON_FILL_SSE2
+    const __m128i t = _mm_set1_epi32((int)target);
+    const __m128i tol = toleranceVector(tolerance);
+    int x = start + 1;
+    for (; x + 16 <= width; x += 16) {
+        int m0 = matchMask4(row + x, t, tol);
+        int m1 = matchMask4(row + x + 4, t, tol);
+        int m2 = matchMask4(row + x + 8, t, tol);
+        int m3 = matchMask4(row + x + 12, t, tol);
+        if ((m0 & m1 & m2 & m3) != 0xFFFF)
+            break;
+    }
+    for (; x + 4 <= width; x += 4) {
+        int miss = ~matchMask4(row + x, t, tol) & 0xFFFF;
+        if (miss)
+            return x + __builtin_ctz(miss) / 4 - 1;
+    }
+    return runEndScalar(row, x - 1, width, target, tolerance);
+#else
+    return runEndScalar(row, start, width, target, tolerance);
+#endif
+}
+
+inline int runBegin(const uint32_t* row, int start, uint32_t target,
+                    int tolerance) {
+#ifdef COMMON_FILL_SSE2
+    const __m128i t = _mm_set1_epi32((int)target);
+    const __m128i tol = toleranceVector(tolerance);
+    int x = start; // row[x..start] all match
+    for (; x - 16 >= 0; x -= 16) {
+        int m0 = matchMask4(row + x - 16, t, tol);
+        int m1 = matchMask4(row + x - 12, t, tol);
+        int m2 = matchMask4(row + x - 8, t, tol);
+        int m3 = matchMask4(row + x - 4, t, tol);
+        if ((m0 & m1 & m2 & m3) != 0xFFFF)
+            break;
+    }
+    for (; x - 4 >= 0; x -= 4) {
+        int miss = ~matchMask4(row + x - 4, t, tol) & 0xFFFF;
+        if (miss) // Highest mismatching pixel ends the run
+            return x - 4 + (31 - __builtin_clz(miss)) / 4 + 1;
+    }
+    return runBeginScalar(row, x, target, tolerance);
+#else
+    return runBeginScalar(row, start, target, tolerance);
+#endif
+}
+
+// One bit per pixel, marking runs a fill has already painted. Needed when
+// painted pixels can still match the region (a colour within the
+// tolerance, or a pattern / gradient). Each row remembers the generation it
+// was last cleared in, so reset() is O(1) and a row is only cleared when
+// the next fill first touches it. Sized from the framebuffer on every fill.
+class VisitedSet {
+  public:
+    void resize(int w, int h) {
+        if (w == width && h == height)
+            return;
+        width = w;
+        height = h;
+        wordsPerRow = (w + 63) / 64;
+        bits.assign((size_t)wordsPerRow * h, 0);
+        rowGen.assign(h, 0);
+        generation = 1;
+    }
+
+    void reset() {
+        if (++generation == 0) { // Wrapped: every row is stale again
+            std::fill(rowGen.begin(), rowGen.end(), 0u);
+            generation = 1;
+        }
+    }
+
+    // Marks x0..x1 on row y.
+    void setRange(int y, int x0, int x1) {
+        uint64_t* w = touch(y);
+        int a = x0 >> 6, b = x1 >> 6;
+        uint64_t first = ~0ull << (x0 & 63);
+        uint64_t last = ~0ull >> (63 - (x1 & 63));
+        if (a == b) {
+            w[a] |= first & last;
+            return;
+        }
+        w[a] |= first;
+        for (int i = a + 1; i < b; ++i)
+            w[i] = ~0ull;
+        w[b] |= last;
+    }
+
+    // First marked x in x0..x1, or x1 + 1 if there is none.
+    int firstSet(int y, int x0, int x1) const {
+        if (rowGen[y] != generation || x0 > x1)
+            return x1 + 1;
+        const uint64_t* w = &bits[(size_t)y * wordsPerRow];
+        for (int i = x0 >> 6; i <= (x1 >> 6); ++i) {
+            uint64_t m = w[i];
+            if (i == (x0 >> 6))
+                m &= ~0ull << (x0 & 63);
+            if (m) {
+                int x = (i << 6) + __builtin_ctzll(m);
+                return x <= x1 ? x : x1 + 1;
+            }
+        }
+        return x1 + 1;
+    }
+
+    // Last marked x in x0..x1, or x0 - 1 if there is none.
+    int lastSet(int y, int x0, int x1) const {
+        if (rowGen[y] != generation || x0 > x1)
+            return x0 - 1;
+        const uint64_t* w = &bits[(size_t)y * wordsPerRow];
+        for (int i = x1 >> 6; i >= (x0 >> 6); --i) {
+            uint64_t m = w[i];
+            if (i == (x1 >> 6))
+                m &= ~0ull >> (63 - (x1 & 63));
+            if (m) {
+                int x = (i << 6) + 63 - __builtin_clzll(m);
+                return x >= x0 ? x : x0 - 1;
+            }
+        }
+        return x0 - 1;
+    }
+
+    bool test(int x, int y) const { return firstSet(y, x, x) == x; }
+
+    size_t bytes() const { return bits.size() * 8 + rowGen.size() * 4; }
+
+  private:
+    uint64_t* touch(int y) {
+        uint64_t* w = &bits[(size_t)y * wordsPerRow];
+        if (rowGen[y] != generation) {
+            std::fill(w, w + wordsPerRow, 0ull);
+            rowGen[y] = generation;
+        }
+        return w;
+    }
+
+    int width = 0, height = 0, wordsPerRow = 0;
+    std::vector<uint64_t> bits;
+    std::vector<uint32_t> rowGen;
+    uint32_t generation = 1;
+};
+
+// A run x1..x2 on row y still to be scanned. dy is the direction the run
+// came from, so only the far side and the overhanging ends get re-queued.
+struct SeedSpan {
+    int x1, x2, y, dy;
+};
+
+class SpanFill {
+  public:
+    // Per-channel colour tolerance of the region, 0 for an exact match.
+    int tolerance = 0;
+
+    // Replaces the 4-connected region of pixels near the seed pixel's
+    // colour. paint(y, xLeft, xRight) is called once per run and may write
+    // anything; painted runs are tracked in a VisitedSet. Returns the number
+    // of pixels painted.
+    template <class SpanFn>
+    long long fill(Framebuffer& fb, int x, int y, SpanFn paint) {
+        return run<true>(fb, x, y, paint);
+    }
+
+    // Solid fill with `color`. Skips the visited set when `color` is
+    // outside the tolerance, since painted pixels then stop matching.
+    long long fill(Framebuffer& fb, int x, int y, uint32_t color) {
+        if (!fb.inside(x, y) || fb.get(x, y) == color)
+            return 0;
+        auto paint = [&](int row, int xl, int xr) {
+            std::fill(fb.row(row) + xl, fb.row(row) + xr + 1, color);
+        };
+        if (colorNear(fb.get(x, y), color, tolerance))
+            return run<true>(fb, x, y, paint);
+        return run<false>(fb, x, y, paint);
+    }
+
+  private:
+    template <bool Track, class SpanFn>
+    long long run(Framebuffer& fb, int x, int y, SpanFn paint) {
+        if (!fb.inside(x, y))
+            return 0;
+        target = fb.get(x, y);
+        if (Track) {
+            visited.resize(fb.width, fb.height);
+            visited.reset();
+        }
+        auto inside = [&](const uint32_t* row, int px, int py) {
+            return matches(row[px]) && !(Track && visited.test(px, py));
+        };
+        long long painted = 0;
+        stack.clear();
+        stack.push_back({x, x, y, 1});
+        stack.push_back({x, x, y - 1, -1});
+        while (!stack.empty()) {
+            SeedSpan s = stack.back();
+            stack.pop_back();
+            if (s.y < 0 || s.y >= fb.height)
+                continue;
+            const uint32_t* row = fb.row(s.y);
+            int x1 = s.x1, x2 = s.x2;
+            int start = x1;
+            if (x1 < fb.width && inside(row, x1, s.y)) {
+                start = runBegin(row, x1, target, tolerance);
+                if (Track)
+                    start = visited.lastSet(s.y, start, x1) + 1;
+                if (start < x1) // Overhang on the left: look back too
+                    push(start, x1 - 1, s.y - s.dy, -s.dy);
+            }
+            int cur = x1;
+            while (cur <= x2 && cur < fb.width) {
+                if (inside(row, cur, s.y)) {
+                    int end = runEnd(row, cur, fb.width, target, tolerance);
+                    if (Track) {
+                        end = visited.firstSet(s.y, cur, end) - 1;
+                        visited.setRange(s.y, start, end);
+                    }
+                    paint(s.y, start, end);
+                    painted += end - start + 1;
+                    push(start, end, s.y + s.dy, s.dy);
+                    if (end > x2) // Overhang on the right
+                        push(x2 + 1, end, s.y - s.dy, -s.dy);
+                    cur = end + 1;
+                }
+                while (cur <= x2 && cur < fb.width && !inside(row, cur, s.y))
+                    ++cur;
+                start = cur;
+            }
+        }
+        return painted;
+    }
+
+    bool matches(uint32_t c) const { return colorNear(c, target, tolerance); }
+
+    void push(int x1, int x2, int y, int dy) {
+        stack.push_back({x1, x2, y, dy});
+    }
+
+    uint32_t target = 0;
+    std::vector<SeedSpan> stack; // Reused between fills
+    VisitedSet visited;
+};
+
+#endif // COMMON_FILL_H
@@ -0,0 +1,239 @@
+#ifndef COMMON_FILL_SHADER_H
+#define COMMON_FILL_SHADER_H
+
+// Fill shaders: objects that paint a whole run row[x0..x1] of row y in one
+// call, used as the paint callback of SpanFill::fill or with
+// RegionLabels::forEachSpan (see paintSpans below). A fill calls them once
+// per span. Gradients look colours up in a 256-entry ramp; along a span the
+// ramp position is stepped in fixed point, and the parts of the span
+// clamped to either end of the ramp are found up front and filled flat, so
+// there is no per-pixel division, sqrt or branch on the range.
+
+#include "color.h"
+#include "framebuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define COMMON_FILL_SHADER_SSE2 1
+#endif
+
+// 256 colours sampled along a gradient.
+struct ColorRamp {
+    uint32_t lut[256];
+
+    // RGB blend from a to b.
+    static ColorRamp between(uint32_t a, uint32_t b) {
+        ColorRamp r;
+        for (int i = 0; i < 256; ++i) {
+            uint32_t c = 0;
+            for (int shift = 0; shift < 24; shift += 8) {
+                int ca = (a >> shift) & 0xFF, cb = (b >> shift) & 0xFF;
+                c |= (uint32_t)((ca * (255 - i) + cb * i + 127) / 255) << shift;
+            }
+            r.lut[i] = c | 0xFF000000u;
+        }
+        return r;
+    }
+
+    // One turn of the HSV hue circle at saturation s and value v.
+    static ColorRamp hueSweep(float s = 1.0f, float v = 1.0f) {
+        ColorRamp r;
+        for (int i = 0; i < 256; ++i) {
+            float red, green, blue;
+            hsvToRgb(i * 360.0f / 256, s, v, &red, &green, &blue);
+            r.lut[i] = packRGBf(red, green, blue);
+        }
+        return r;
+    }
+};
+
+inline int64_t floorDiv(int64_t a, int64_t b) { // b > 0
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+// Writes row[x0..x1] from lut at ramp position t(x) = t0 + (x - x0) * dt,
+// in 1/65536 of an entry, clamping to the first and last entries.
+inline void rampSpan(uint32_t* row, int x0, int x1, int64_t t0, int64_t dt,
+                     const uint32_t* lut) {
+    const int64_t top = ((int64_t)256 << 16) - 1; // Last position in range
+    const int n = x1 - x0 + 1;
+    // Steps k with 0 <= t0 + k * dt <= top are kLo..kHi.
+    int64_t kLo, kHi;
+    if (dt > 0) {
+        kLo = -floorDiv(t0, dt);
+        kHi = floorDiv(top - t0, dt);
+    } else if (dt < 0) {
+        kLo = -floorDiv(top - t0, -dt);
+        kHi = floorDiv(t0, -dt);
+    } else {
+        bool in = t0 >= 0 && t0 <= top;
+        kLo = in ? 0 : n;
+        kHi = in ? n - 1 : -1;
+    }
+    int lo = (int)std::max<int64_t>(0, std::min<int64_t>(kLo, n));
+    int hi = (int)std::max<int64_t>(lo - 1, std::min<int64_t>(kHi, n - 1));
+    // Before the range t is below 0 when rising, past the top when falling.
+    uint32_t before = (dt < 0 || (dt == 0 && t0 > top)) ? lut[255] : lut[0];
+    uint32_t after = dt > 0 ? lut[255] : lut[0];
+    std::fill(row + x0, row + x0 + lo, before);
+    int64_t t = t0 + lo * dt;
+    for (int x = x0 + lo; x <= x0 + hi; ++x, t += dt)
+        row[x] = lut[t >> 16];
+    std::fill(row + x0 + hi + 1, row + x1 + 1, after);
+}
+
+// Ramp along the segment (x0, y0) -> (x1, y1), constant across it and
+// clamped past the ends.
+class LinearGradient {
+  public:
+    LinearGradient(const ColorRamp& ramp, float x0, float y0, float x1,
+                   float y1)
+        : ramp(ramp), ox(x0), oy(y0) {
+        double dx = x1 - x0, dy = y1 - y0;
+        double len2 = std::max(dx * dx + dy * dy, 1e-12);
+        stepX = dx / len2 * (256 << 16);
+        stepY = dy / len2 * (256 << 16);
+    }
+
+    void operator()(uint32_t* row, int y, int x0, int x1) const {
+        double t = (x0 + 0.5 - ox) * stepX + (y + 0.5 - oy) * stepY;
+        rampSpan(row, x0, x1, (int64_t)std::floor(t), std::llround(stepX),
+                 ramp.lut);
+    }
+
+  private:
+    ColorRamp ramp;
+    double ox, oy, stepX, stepY; // Ramp position per pixel, fixed point
+};
+
+// Ramp from the centre out to `radius`, the last colour beyond it. A table
+// over t^2 replaces the per-pixel square root; the span is clipped to the
+// circle with one sqrt per span, and the inside part computes the squared
+// distance four pixels at a time (SSE2) or adds the odd numbers.
+class RadialGradient {
+  public:
+    RadialGradient(const ColorRamp& ramp, float cx, float cy, float radius)
+        : outside(ramp.lut[255]), cx(cx), cy(cy),
+          r2(std::max((double)radius * radius, 1e-12)),
+          bySquare(SQUARE_STEPS) {
+        for (int i = 0; i < SQUARE_STEPS; ++i) {
+            double t = std::sqrt((i + 0.5) / SQUARE_STEPS);
+            bySquare[i] = ramp.lut[std::min(255, (int)(t * 256))];
+        }
+    }
+
+    void operator()(uint32_t* row, int y, int x0, int x1) const {
+        double dy = y + 0.5 - cy;
+        double w2 = r2 - dy * dy;
+        int a = x1 + 1, b = x1; // Pixels with centres inside: a..b
+        if (w2 > 0) {
+            double w = std::sqrt(w2);
+            a = std::max(x0, (int)std::ceil(cx - 0.5 - w));
+            b = std::min(x1, (int)std::floor(cx - 0.5 + w));
+        }
+        if (a > b) {
+            std::fill(row + x0, row + x1 + 1, outside);
+            return;
+        }
+        std::fill(row + x0, row + a, outside);
+        const double scale = SQUARE_STEPS / r2;
+        int x = a;
+#ifdef COMMON_FILL_SHADER_SSE2
+        // Four pixels per step: table indices from (dx^2 + dy^2) * scale.
+        const __m128 fs = _mm_set1_ps((float)scale);
+        const __m128 fdy2 = _mm_set1_ps((float)(dy * dy * scale));
+        const __m128i last = _mm_set1_epi16(SQUARE_STEPS - 1);
+        __m128 fdx = _mm_add_ps(_mm_set1_ps((float)(a + 0.5 - cx)),
+                                _mm_setr_ps(0, 1, 2, 3));
+        const __m128 four = _mm_set1_ps(4);
+        for (; x + 3 <= b; x += 4) {
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(fdx, fdx), fs), fdy2);
+            // Indices are below 2^15, so 16-bit min and extracts are enough
+            __m128i i = _mm_min_epi16(_mm_cvttps_epi32(d2), last);
+            row[x] = bySquare[_mm_extract_epi16(i, 0)];
+            row[x + 1] = bySquare[_mm_extract_epi16(i, 2)];
+            row[x + 2] = bySquare[_mm_extract_epi16(i, 4)];
+            row[x + 3] = bySquare[_mm_extract_epi16(i, 6)];
+            fdx = _mm_add_ps(fdx, four);
+        }
+#endif
+        double dx = x + 0.5 - cx;
+        double d2 = dx * dx + dy * dy, dd = 2 * dx + 1;
+        for (; x <= b; ++x) {
+            int i = std::min(SQUARE_STEPS - 1, (int)(d2 * scale));
+            row[x] = bySquare[i];
+            d2 += dd;
+            dd += 2;
+        }
+        std::fill(row + b + 1, row + x1 + 1, outside);
+    }
+
+  private:
+    static const int SQUARE_STEPS = 4096;
+    uint32_t outside;
+    double cx, cy, r2;
+    std::vector<uint32_t> bySquare; // Ramp colour by (distance / radius)^2
+};
+
+// A tile repeated over the plane. Tile rows are stored repeated to at
+// least 64 pixels, so a span is painted with a few long copies.
+class PatternShader {
+  public:
+    // w x h texels, bottom row first like the framebuffer; the tile's
+    // bottom-left corner is at (originX, originY).
+    PatternShader(int w, int h, const uint32_t* texels, int originX = 0,
+                  int originY = 0)
+        : w(w), h(h), ox(originX), oy(originY) {
+        wide = w * ((64 + w - 1) / w);
+        rows.resize((size_t)wide * h);
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < wide; ++x)
+                rows[(size_t)y * wide + x] = texels[y * w + x % w];
+    }
+
+    // Tile from strings of equal length, top row first: 'X' is fg and
+    // anything else bg.
+    static PatternShader bitmap(const char* const* lines, int h, uint32_t fg,
+                                uint32_t bg) {
+        int w = (int)strlen(lines[0]);
+        std::vector<uint32_t> texels((size_t)w * h);
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+                texels[(size_t)(h - 1 - y) * w + x] =
+                    lines[y][x] == 'X' ? fg : bg;
+        return PatternShader(w, h, texels.data());
+    }
+
+    void operator()(uint32_t* row, int y, int x0, int x1) const {
+        const uint32_t* src = &rows[(size_t)wrap(y - oy, h) * wide];
+        int off = wrap(x0 - ox, w);
+        for (int x = x0; x <= x1;) {
+            int n = std::min(x1 - x + 1, wide - off);
+            std::copy_n(src + off, n, row + x);
+            x += n;
+            off = 0;
+        }
+    }
+
+  private:
+    static int wrap(int v, int m) { return ((v % m) + m) % m; }
+
+    int w, h, wide, ox, oy;
+    std::vector<uint32_t> rows;
+};
+
+// paint(y, xLeft, xRight) callback drawing `shader` into fb.
+template <class Shader>
+auto paintSpans(Framebuffer& fb, const Shader& shader) {
+    return [&fb, &shader](int y, int xl, int xr) {
+        shader(fb.row(y), y, xl, xr);
+    };
+}
+
+#endif // COMMON_FILL_SHADER_H
@@ -0,0 +1,110 @@
+#ifndef COMMON_FRAMEBUFFER_H
+#define COMMON_FRAMEBUFFER_H
+
+// In-memory RGBA8 render target shared by the lab rasterizers.
+// The algorithms write straight into `pixels`; the finished frame is either
+// uploaded once as a texture (framebuffer_gl.h) or saved to disk (image_io.h).
+
+#include "line_kernels.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// Bytes end up as R, G, B, A in memory (little-endian), which is the layout
+// GL_RGBA / GL_UNSIGNED_BYTE and PNG both expect.
+inline uint32_t packRGBA(int r, int g, int b, int a = 255) {
+    return (uint32_t)r | ((uint32_t)g << 8) | ((uint32_t)b << 16) |
+           ((uint32_t)a << 24);
+}
+
+inline uint32_t packRGBf(float r, float g, float b) {
+    auto to8 = [](float v) {
+        v = v < 0.f ? 0.f : (v > 1.f ? 1.f : v);
+        return (int)(v * 255.f + 0.5f);
+    };
+    return packRGBA(to8(r), to8(g), to8(b));
+}
+
+inline void unpackRGBf(uint32_t c, float rgb[3]) {
+    rgb[0] = (c & 0xFF) / 255.f;
+    rgb[1] = ((c >> 8) & 0xFF) / 255.f;
+    rgb[2] = ((c >> 16) & 0xFF) / 255.f;
+}
+
+struct Framebuffer {
+    int width = 0, height = 0;
+    std::vector<uint32_t> pixels; // Row 0 is the bottom row, like gluOrtho2D
+    uint32_t color = packRGBA(0, 0, 0);
+    int pointSize = 1; // Square stamp size used by putPixel, like glPointSize
+
+    Framebuffer() {}
+    Framebuffer(int w, int h) { resize(w, h); }
+
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        pixels.assign((size_t)w * h, packRGBA(0, 0, 0));
+    }
+
+    void clear(uint32_t c) { std::fill(pixels.begin(), pixels.end(), c); }
+    void setColor(float r, float g, float b) { color = packRGBf(r, g, b); }
+
+    bool inside(int x, int y) const {
+        return x >= 0 && y >= 0 && x < width && y < height;
+    }
+    uint32_t* row(int y) { return &pixels[(size_t)y * width]; }
+    const uint32_t* row(int y) const { return &pixels[(size_t)y * width]; }
+    uint32_t get(int x, int y) const { return row(y)[x]; }
+
+    // Single pixel, no point size, no bounds check.
+    void set(int x, int y, uint32_t c) { row(y)[x] = c; }
+
+    // Plots one "GL point": a pointSize x pointSize square around (x, y).
+    void putPixel(int x, int y) {
+        if (pointSize <= 1) {
+            if (inside(x, y))
+                row(y)[x] = color;
+            return;
+        }
+        int x0 = x - pointSize / 2, y0 = y - pointSize / 2;
+        fillRect(x0, y0, x0 + pointSize - 1, y0 + pointSize - 1);
+    }
+
+    // putPixel for every pixel of [x0, x1] on row y, as one rect fill.
+    void putSpan(int y, int x0, int x1) {
+        if (x0 > x1)
+            std::swap(x0, x1);
+        int s = pointSize < 1 ? 1 : pointSize;
+        fillRect(x0 - s / 2, y - s / 2, x1 - s / 2 + s - 1, y - s / 2 + s - 1);
+    }
+
+    // Inclusive horizontal run [x0, x1] on row y, clipped to the buffer.
+    // std::fill_n over a contiguous row compiles to wide vector stores.
+    void fillSpan(int y, int x0, int x1) {
+        if (y < 0 || y >= height)
+            return;
+        if (x0 > x1)
+            std::swap(x0, x1);
+        x0 = std::max(x0, 0);
+        x1 = std::min(x1, width - 1);
+        if (x0 <= x1)
+            std::fill_n(row(y) + x0, x1 - x0 + 1, color);
+    }
+
+    void fillRect(int x0, int y0, int x1, int y1) {
+        if (y0 > y1)
+            std::swap(y0, y1);
+        for (int y = std::max(y0, 0); y <= std::min(y1, height - 1); ++y)
+            fillSpan(y, x0, x1);
+    }
+
+    // Plain Bresenham, for outlines and axes that are not the subject of
+    // the lab itself.
+    void drawLine(int x1, int y1, int x2, int y2) {
+        bresenhamLine(x1, y1, x2, y2, [this](int x, int y) { putPixel(x, y); });
+    }
+};
+
+#endif // COMMON_FRAMEBUFFER_H
@@ -0,0 +1,59 @@
+#ifndef COMMON_FRAMEBUFFER_GL_H
+#define COMMON_FRAMEBUFFER_GL_H
+
+// Uploads a Framebuffer as one texture per frame and draws it as a single
+// quad covering the gluOrtho2D(0, width, 0, height) projection.
+
+#include "framebuffer.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#ifdef __APPLE__
+#include <GLUT/glut.h>
+#else
+#include <GL/glut.h>
+#endif
+
+inline void presentFramebuffer(const Framebuffer& fb) {
+    static GLuint tex = 0;
+    static int texW = 0, texH = 0;
+
+    if (tex == 0) {
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        // Nearest filtering keeps the rasterized pixels crisp when the
+        // window is larger than the logical framebuffer.
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (texW != fb.width || texH != fb.height) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, fb.width, fb.height, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, fb.pixels.data());
+        texW = fb.width;
+        texH = fb.height;
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, fb.width, fb.height, GL_RGBA,
+                        GL_UNSIGNED_BYTE, fb.pixels.data());
+    }
+
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    glBegin(GL_QUADS);
+    glTexCoord2f(0, 0);
+    glVertex2i(0, 0);
+    glTexCoord2f(1, 0);
+    glVertex2i(fb.width, 0);
+    glTexCoord2f(1, 1);
+    glVertex2i(fb.width, fb.height);
+    glTexCoord2f(0, 1);
+    glVertex2i(0, fb.height);
+    glEnd();
+    glDisable(GL_TEXTURE_2D);
+}
+
+#endif // COMMON_FRAMEBUFFER_GL_H
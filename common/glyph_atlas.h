@@ -0,0 +1,298 @@
+#ifndef COMMON_GLYPH_ATLAS_H
+#define COMMON_GLYPH_ATLAS_H
+
+// Text from a GLUT bitmap font as textured quads. The first draw with a
+// font bakes its printable glyphs into one alpha texture: they are drawn
+// with glutBitmapCharacter into an offscreen framebuffer object and read
+// back, so nothing is drawn on screen and the window's size, buffering and
+// visibility do not matter. After that, each distinct string is laid out
+// once into a quad array, and drawing it is a single glDrawArrays call
+// instead of one glBitmap per character per frame.
+//
+// drawBitmapText(x, y, s, font) replaces
+//     glRasterPos2f(x, y);
+//     for (char c : s) glutBitmapCharacter(font, c);
+// It uses the same position (the raster position of (x, y)), the current
+// colour and the same glyph pixels. Without GL_EXT_framebuffer_object (or
+// without freeglut's glutGetProcAddress to load it) it is exactly that
+// loop. The atlas is per GL context, so it assumes one window.
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#ifdef __APPLE__
+#include <GLUT/glut.h>
+#else
+#include <GL/glut.h>
+#endif
+#if defined(__APPLE__)
+#include <OpenGL/glext.h>
+#elif defined(FREEGLUT)
+#include <GL/freeglut_ext.h> // glutGetProcAddress
+#endif
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class GlyphAtlas {
+  public:
+    explicit GlyphAtlas(void* font) : font(font) {}
+
+    void* glutFont() const { return font; }
+
+    void draw(float x, float y, const std::string& s) {
+        if (s.empty())
+            return;
+        if (!baked) {
+            baked = true;
+            bake();
+        }
+        if (texture == 0) {
+            // No offscreen target: one bitmap per character, uncached
+            glRasterPos2f(x, y);
+            for (char c : s)
+                glutBitmapCharacter(font, c);
+            return;
+        }
+
+        // Where glRasterPos would put the text, in window pixels
+        glRasterPos2f(x, y);
+        GLint valid = 0;
+        glGetIntegerv(GL_CURRENT_RASTER_POSITION_VALID, &valid);
+        if (!valid)
+            return;
+        GLfloat pos[4];
+        glGetFloatv(GL_CURRENT_RASTER_POSITION, pos);
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        const std::vector<float>& quads = layout(s);
+
+        glPushAttrib(GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_COLOR_BUFFER_BIT);
+        glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glLoadIdentity();
+        glOrtho(0, viewport[2], 0, viewport[3], -1, 1);
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
+        glTranslatef(std::floor(pos[0]), std::floor(pos[1]), 0);
+
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_LIGHTING);
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glVertexPointer(2, GL_FLOAT, 4 * sizeof(float), quads.data());
+        glTexCoordPointer(2, GL_FLOAT, 4 * sizeof(float), quads.data() + 2);
+        glDrawArrays(GL_QUADS, 0, (GLsizei)(quads.size() / 4));
+
+        glPopMatrix();
+        glMatrixMode(GL_PROJECTION);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+        glPopClientAttrib();
+        glPopAttrib();
+    }
+
+  private:
+    static const int FIRST = 32, LAST = 126; // Printable ASCII
+    static const int ATLAS_WIDTH = 512;
+    static const int CELL_HEIGHT = 40; // Fits the tallest GLUT font
+    static const int BASELINE = 10;    // Room for descenders
+    static const int PAD = 2;          // Room for glyphs left of the pen
+    static const size_t MAX_STRINGS = 2048; // Layouts kept before a reset
+
+    struct Glyph {
+        int x, y, w;  // Cell in the atlas
+        int advance;
+    };
+
+    // GL_EXT_framebuffer_object, loaded at run time except on macOS
+    struct FramebufferApi {
+        void(APIENTRY* gen)(GLsizei, GLuint*);
+        void(APIENTRY* del)(GLsizei, const GLuint*);
+        void(APIENTRY* bind)(GLenum, GLuint);
+        void(APIENTRY* texture2D)(GLenum, GLenum, GLenum, GLuint, GLint);
+        GLenum(APIENTRY* status)(GLenum);
+    };
+    static const GLenum FRAMEBUFFER = 0x8D40, COLOR_ATTACHMENT0 = 0x8CE0;
+    static const GLenum FRAMEBUFFER_COMPLETE = 0x8CD5;
+    static const GLenum FRAMEBUFFER_BINDING = 0x8CA6;
+
+    static bool framebufferApi(FramebufferApi& fb) {
+        const char* ext = (const char*)glGetString(GL_EXTENSIONS);
+        if (!ext || !std::strstr(ext, "GL_EXT_framebuffer_object"))
+            return false;
+#if defined(__APPLE__)
+        fb.gen = glGenFramebuffersEXT;
+        fb.del = glDeleteFramebuffersEXT;
+        fb.bind = glBindFramebufferEXT;
+        fb.texture2D = glFramebufferTexture2DEXT;
+        fb.status = glCheckFramebufferStatusEXT;
+#elif defined(FREEGLUT)
+        fb.gen = (decltype(fb.gen))glutGetProcAddress("glGenFramebuffersEXT");
+        fb.del =
+            (decltype(fb.del))glutGetProcAddress("glDeleteFramebuffersEXT");
+        fb.bind = (decltype(fb.bind))glutGetProcAddress("glBindFramebufferEXT");
+        fb.texture2D = (decltype(fb.texture2D))glutGetProcAddress(
+            "glFramebufferTexture2DEXT");
+        fb.status = (decltype(fb.status))glutGetProcAddress(
+            "glCheckFramebufferStatusEXT");
+#else
+        return false;
+#endif
+        return fb.gen && fb.del && fb.bind && fb.texture2D && fb.status;
+    }
+
+    // Draws every glyph white on black into an offscreen framebuffer and
+    // reads it back as the alpha texture. Leaves texture at 0 when there
+    // is no usable framebuffer object.
+    void bake() {
+        FramebufferApi fb;
+        if (!framebufferApi(fb))
+            return;
+        int x = 0, y = 0;
+        for (int c = FIRST; c <= LAST; ++c) {
+            int advance = glutBitmapWidth(font, c);
+            int w = advance + 2 * PAD;
+            if (x + w > ATLAS_WIDTH) {
+                x = 0;
+                y += CELL_HEIGHT;
+            }
+            glyphs[c - FIRST] = {x, y, w, advance};
+            x += w;
+        }
+        const int used = y + CELL_HEIGHT;
+        height = 1;
+        while (height < used) // Power of two for GL 1.1
+            height *= 2;
+
+        GLint previous = 0;
+        glGetIntegerv(FRAMEBUFFER_BINDING, (GLint*)&previous);
+        glPushAttrib(GL_ALL_ATTRIB_BITS);
+        glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+        GLuint target = 0, frame = 0;
+        glGenTextures(1, &target);
+        glBindTexture(GL_TEXTURE_2D, target);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ATLAS_WIDTH, height, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        fb.gen(1, &frame);
+        fb.bind(FRAMEBUFFER, frame);
+        fb.texture2D(FRAMEBUFFER, COLOR_ATTACHMENT0, GL_TEXTURE_2D, target,
+                     0);
+        std::vector<unsigned char> pixels;
+        if (fb.status(FRAMEBUFFER) == FRAMEBUFFER_COMPLETE) {
+            glViewport(0, 0, ATLAS_WIDTH, used);
+            glMatrixMode(GL_PROJECTION);
+            glPushMatrix();
+            glLoadIdentity();
+            glOrtho(0, ATLAS_WIDTH, 0, used, -1, 1);
+            glMatrixMode(GL_MODELVIEW);
+            glPushMatrix();
+            glLoadIdentity();
+            glDisable(GL_SCISSOR_TEST);
+            glDisable(GL_BLEND);
+            glDisable(GL_TEXTURE_2D);
+            glDisable(GL_DEPTH_TEST);
+            glDisable(GL_LIGHTING);
+            glClearColor(0, 0, 0, 0);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glColor3f(1, 1, 1);
+            for (int c = FIRST; c <= LAST; ++c) {
+                const Glyph& g = glyphs[c - FIRST];
+                glRasterPos2i(g.x + PAD, g.y + BASELINE);
+                glutBitmapCharacter(font, c);
+            }
+            pixels.resize((size_t)ATLAS_WIDTH * used * 4);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(0, 0, ATLAS_WIDTH, used, GL_RGBA, GL_UNSIGNED_BYTE,
+                         pixels.data());
+            glPopMatrix();
+            glMatrixMode(GL_PROJECTION);
+            glPopMatrix();
+            glMatrixMode(GL_MODELVIEW);
+        }
+        fb.bind(FRAMEBUFFER, (GLuint)previous);
+        fb.del(1, &frame);
+        glDeleteTextures(1, &target);
+
+        if (!pixels.empty()) {
+            // Coverage from the red channel
+            std::vector<unsigned char> alpha((size_t)ATLAS_WIDTH * height, 0);
+            for (size_t i = 0; i < (size_t)ATLAS_WIDTH * used; ++i)
+                alpha[i] = pixels[4 * i];
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8, ATLAS_WIDTH, height, 0,
+                         GL_ALPHA, GL_UNSIGNED_BYTE, alpha.data());
+        }
+        glPopClientAttrib();
+        glPopAttrib();
+    }
+
+    // x, y, u, v for four corners per glyph, with the pen starting at the
+    // origin on the baseline. Cached per string.
+    const std::vector<float>& layout(const std::string& s) {
+        auto it = layouts.find(s);
+        if (it != layouts.end())
+            return it->second;
+        if (layouts.size() >= MAX_STRINGS)
+            layouts.clear();
+        std::vector<float>& q = layouts[s];
+        q.reserve(s.size() * 16);
+        float pen = 0;
+        const float su = 1.0f / ATLAS_WIDTH, sv = 1.0f / height;
+        for (unsigned char c : s) {
+            if (c < FIRST || c > LAST)
+                continue;
+            const Glyph& g = glyphs[c - FIRST];
+            float x0 = pen - PAD, y0 = -BASELINE;
+            float x1 = x0 + g.w, y1 = y0 + CELL_HEIGHT;
+            float u0 = g.x * su, v0 = g.y * sv;
+            float u1 = (g.x + g.w) * su, v1 = (g.y + CELL_HEIGHT) * sv;
+            float corners[16] = {x0, y0, u0, v0, x1, y0, u1, v0,
+                                 x1, y1, u1, v1, x0, y1, u0, v1};
+            q.insert(q.end(), corners, corners + 16);
+            pen += g.advance;
+        }
+        return q;
+    }
+
+    void* font;
+    bool baked = false; // bake() has run; texture stays 0 if it failed
+    GLuint texture = 0;
+    int height = 0; // Texture rows
+    Glyph glyphs[LAST - FIRST + 1];
+    std::unordered_map<std::string, std::vector<float>> layouts;
+};
+
+// One atlas per font, baked on first use.
+inline GlyphAtlas& glyphAtlas(void* font) {
+    static std::vector<std::unique_ptr<GlyphAtlas>> atlases;
+    for (auto& a : atlases)
+        if (a->glutFont() == font)
+            return *a;
+    atlases.emplace_back(new GlyphAtlas(font));
+    return *atlases.back();
+}
+
+inline void drawBitmapText(float x, float y, const std::string& s,
+                           void* font) {
+    glyphAtlas(font).draw(x, y, s);
+}
+
+#endif // COMMON_GLYPH_ATLAS_H
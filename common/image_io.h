@@ -0,0 +1,105 @@
+#ifndef COMMON_IMAGE_IO_H
+#define COMMON_IMAGE_IO_H
+
+// Dependency-free PNG writer for headless runs. The image data goes into
+// uncompressed ("stored") deflate blocks, so no zlib is needed.
+
+#include "framebuffer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+inline uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t n) {
+    static uint32_t table[256];
+    static bool ready = false;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        ready = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+inline void pngPutU32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back((uint8_t)(v >> 24));
+    out.push_back((uint8_t)(v >> 16));
+    out.push_back((uint8_t)(v >> 8));
+    out.push_back((uint8_t)v);
+}
+
+inline void pngChunk(std::vector<uint8_t>& out, const char* type,
+                     const std::vector<uint8_t>& data) {
+    pngPutU32(out, (uint32_t)data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    pngPutU32(out, crc32Update(0, &out[start], out.size() - start));
+}
+
+// Writes the framebuffer top row first, as image viewers expect.
+inline bool writePng(const char* path, const Framebuffer& fb) {
+    // Raw scanlines: filter byte 0 followed by RGBA8 pixels.
+    size_t stride = (size_t)fb.width * 4 + 1;
+    std::vector<uint8_t> raw(stride * fb.height);
+    for (int y = 0; y < fb.height; ++y) {
+        uint8_t* dst = &raw[stride * y];
+        dst[0] = 0;
+        std::memcpy(dst + 1, fb.row(fb.height - 1 - y), (size_t)fb.width * 4);
+    }
+
+    std::vector<uint8_t> z = {0x78, 0x01};
+    uint32_t a = 1, b = 0; // Adler-32
+    for (size_t pos = 0;;) {
+        size_t n = std::min<size_t>(65535, raw.size() - pos);
+        bool last = pos + n == raw.size();
+        z.push_back(last ? 1 : 0);
+        z.push_back((uint8_t)n);
+        z.push_back((uint8_t)(n >> 8));
+        z.push_back((uint8_t)~n);
+        z.push_back((uint8_t)(~n >> 8));
+        z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + n);
+        for (size_t i = pos; i < pos + n; ++i) {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        pos += n;
+        if (last)
+            break;
+    }
+    pngPutU32(z, (b << 16) | a);
+
+    std::vector<uint8_t> ihdr;
+    pngPutU32(ihdr, (uint32_t)fb.width);
+    pngPutU32(ihdr, (uint32_t)fb.height);
+    ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0}); // 8-bit RGBA, no interlace
+
+    std::vector<uint8_t> out = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    pngChunk(out, "IHDR", ihdr);
+    pngChunk(out, "IDAT", z);
+    pngChunk(out, "IEND", {});
+
+    FILE* f = std::fopen(path, "wb");
+    if (!f)
+        return false;
+    bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+// Returns the output path when the program was started as
+// `prog --headless out.png`, otherwise nullptr.
+inline const char* headlessPath(int argc, char** argv) {
+    if (argc >= 3 && std::strcmp(argv[1], "--headless") == 0)
+        return argv[2];
+    return nullptr;
+}
+
+#endif // COMMON_IMAGE_IO_H
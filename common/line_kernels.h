@@ -0,0 +1,60 @@
+#ifndef COMMON_LINE_KERNELS_H
+#define COMMON_LINE_KERNELS_H
+
+// Bresenham line kernels specialised per octant at compile time.
+// The classic loop tests `e2 > -dy` and `e2 < dx` and multiplies by sx / sy
+// on every pixel. Here the octant is picked once per line: the major axis
+// and both step directions are template parameters, so the inner loop
+// always steps the major axis and has one branch for the minor one.
+//
+// The pixels and their order are exactly those of the err = dx - dy loop
+// used throughout the labs. At major step k its minor offset is
+// floor((2k * dMinor + dMajor - 1) / (2 * dMajor)), which is what the
+// error term below tracks.
+
+#include <cstdlib>
+
+template <bool XMajor, int SMajor, int SMinor, class PlotFn>
+inline void bresenhamOctant(int x, int y, int dMaj, int dMin, PlotFn& plot) {
+    int err = -dMaj - 1; // Crosses 0 when the minor axis must step
+    const int inc = dMin << 1, dec = dMaj << 1;
+    for (int k = 0; k <= dMaj; ++k) {
+        plot(x, y);
+        err += inc;
+        if (err >= 0) {
+            err -= dec;
+            if (XMajor)
+                y += SMinor;
+            else
+                x += SMinor;
+        }
+        if (XMajor)
+            x += SMajor;
+        else
+            y += SMajor;
+    }
+}
+
+// Calls plot(x, y) for every pixel from (x1, y1) to (x2, y2), in order.
+template <class PlotFn>
+inline void bresenhamLine(int x1, int y1, int x2, int y2, PlotFn plot) {
+    int dx = std::abs(x2 - x1), dy = std::abs(y2 - y1);
+    bool xNeg = x2 < x1, yNeg = y2 < y1;
+    if (dx >= dy) {
+        if (!xNeg)
+            yNeg ? bresenhamOctant<true, 1, -1>(x1, y1, dx, dy, plot)
+                 : bresenhamOctant<true, 1, 1>(x1, y1, dx, dy, plot);
+        else
+            yNeg ? bresenhamOctant<true, -1, -1>(x1, y1, dx, dy, plot)
+                 : bresenhamOctant<true, -1, 1>(x1, y1, dx, dy, plot);
+    } else {
+        if (!yNeg)
+            xNeg ? bresenhamOctant<false, 1, -1>(x1, y1, dy, dx, plot)
+                 : bresenhamOctant<false, 1, 1>(x1, y1, dy, dx, plot);
+        else
+            xNeg ? bresenhamOctant<false, -1, -1>(x1, y1, dy, dx, plot)
+                 : bresenhamOctant<false, -1, 1>(x1, y1, dy, dx, plot);
+    }
+}
+
+#endif // COMMON_LINE_KERNELS_H
@@ -0,0 +1,141 @@
+#ifndef COMMON_POLYGON_CLIP_H
+#define COMMON_POLYGON_CLIP_H
+
+// Clipping of connected geometry against a ClipWindow or a ConvexWindow,
+// keeping the connectivity that per-segment clipping loses.
+//   - Closed polygons use Sutherland-Hodgman: the vertex loop is clipped by
+//     one half-plane of the window at a time, which gives one output polygon.
+//     A concave input that the window cuts in several places comes out as
+//     one polygon with zero-width bridges along the window border. An
+//     even-odd fill (PolygonFiller) paints it correctly.
+//   - Open polylines are clipped segment by segment (liangBarsky() or
+//     cyrusBeck()). Consecutive visible pieces are joined into runs, so the
+//     output is a list of polylines.
+// The output lives in buffers owned by the clipper and reused between
+// calls, so once they have grown no clip allocates.
+
+#include "clip_batch.h"
+#include "convex_clip.h"
+
+#include <cmath>
+#include <vector>
+
+class PolygonClipper {
+  public:
+    // Clips the polygon (xs[i], ys[i]), i < n, against w. Returns the
+    // number of output vertices (0 when nothing is inside); they are
+    // x()[i], y()[i] until the next call.
+    int clipPolygon(const float* xs, const float* ys, int n,
+                    const ClipWindow& w) {
+        planes.clear();
+        planes.push_back({1, 0, w.xmin});
+        planes.push_back({-1, 0, -w.xmax});
+        planes.push_back({0, 1, w.ymin});
+        planes.push_back({0, -1, -w.ymax});
+        return clipByPlanes(xs, ys, n);
+    }
+
+    int clipPolygon(const float* xs, const float* ys, int n,
+                    const ConvexWindow& w) {
+        planes.clear();
+        for (size_t k = 0; k < w.slabs(); ++k) {
+            planes.push_back({w.nx[k], w.ny[k], w.lo[k]});
+            if (std::isfinite(w.hi[k]))
+                planes.push_back({-w.nx[k], -w.ny[k], -w.hi[k]});
+        }
+        return clipByPlanes(xs, ys, n);
+    }
+
+    // Clips the open polyline (xs[i], ys[i]), i < n, against w. Returns
+    // the number of visible runs; run k is vertices
+    // runStart(k) .. runStart(k + 1) - 1 of x(), y().
+    template <class Window>
+    int clipPolyline(const float* xs, const float* ys, int n,
+                     const Window& w) {
+        outX.clear();
+        outY.clear();
+        starts.clear();
+        bool open = false; // The last run ends at the current vertex
+        for (int i = 0; i + 1 < n; ++i) {
+            float t0, t1;
+            if (!clipSegment(xs[i], ys[i], xs[i + 1], ys[i + 1], w, t0, t1)) {
+                open = false;
+                continue;
+            }
+            float dx = xs[i + 1] - xs[i], dy = ys[i + 1] - ys[i];
+            if (!open || t0 > 0.0f) {
+                starts.push_back((int)outX.size());
+                outX.push_back(xs[i] + t0 * dx);
+                outY.push_back(ys[i] + t0 * dy);
+            }
+            outX.push_back(t1 < 1.0f ? xs[i] + t1 * dx : xs[i + 1]);
+            outY.push_back(t1 < 1.0f ? ys[i] + t1 * dy : ys[i + 1]);
+            open = t1 >= 1.0f;
+        }
+        starts.push_back((int)outX.size());
+        return (int)starts.size() - 1;
+    }
+
+    const float* x() const { return outX.data(); }
+    const float* y() const { return outY.data(); }
+    int size() const { return (int)outX.size(); }
+    int runStart(int k) const { return starts[k]; }
+
+  private:
+    struct HalfPlane {
+        float a, b, c; // Inside when a * x + b * y >= c
+    };
+
+    static bool clipSegment(float x0, float y0, float x1, float y1,
+                            const ClipWindow& w, float& t0, float& t1) {
+        return liangBarsky(x0, y0, x1, y1, w, t0, t1);
+    }
+    static bool clipSegment(float x0, float y0, float x1, float y1,
+                            const ConvexWindow& w, float& t0, float& t1) {
+        return cyrusBeck(x0, y0, x1, y1, w, t0, t1);
+    }
+
+    int clipByPlanes(const float* xs, const float* ys, int n) {
+        outX.assign(xs, xs + n);
+        outY.assign(ys, ys + n);
+        for (const HalfPlane& h : planes) {
+            int m = (int)outX.size();
+            if (m == 0)
+                break;
+            std::swap(outX, inX);
+            std::swap(outY, inY);
+            outX.clear();
+            outY.clear();
+            float sx = inX[m - 1], sy = inY[m - 1];
+            float ds = h.a * sx + h.b * sy - h.c;
+            for (int i = 0; i < m; ++i) {
+                float ex = inX[i], ey = inY[i];
+                float de = h.a * ex + h.b * ey - h.c;
+                if ((ds >= 0.0f) != (de >= 0.0f)) {
+                    // The edge crosses the boundary: emit the crossing
+                    float t = ds / (ds - de);
+                    outX.push_back(sx + t * (ex - sx));
+                    outY.push_back(sy + t * (ey - sy));
+                }
+                if (de >= 0.0f) {
+                    outX.push_back(ex);
+                    outY.push_back(ey);
+                }
+                sx = ex;
+                sy = ey;
+                ds = de;
+            }
+        }
+        if (outX.size() < 3) {
+            outX.clear();
+            outY.clear();
+        }
+        return (int)outX.size();
+    }
+
+    std::vector<HalfPlane> planes;
+    std::vector<float> inX, inY, outX, outY; // Swapped between half-planes
+    std::vector<int> starts;                 // Polyline runs
+};
+
+#endif // COMMON_POLYGON_CLIP_H
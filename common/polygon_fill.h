@@ -0,0 +1,118 @@
+#ifndef COMMON_POLYGON_FILL_H
+#define COMMON_POLYGON_FILL_H
+
+// Scanline polygon fill with an edge table and an active edge table, for
+// shapes whose geometry is known: no seed and no framebuffer reads. The
+// edge table is sorted by first row; each row adds the edges starting there,
+// drops the ones that ended, sorts the active crossings (insertion sort,
+// since the order barely changes between rows) and emits the spans between
+// pairs of crossings (even-odd rule).
+//
+// Sampling follows convexPolygonSpans() in thick_line.h: pixel (x, y) is
+// covered when its centre lies inside, with left/bottom edges in and
+// right/top edges out, so polygons sharing an edge never overlap. Circles
+// are filled with RingFiller from ring.h (inner radius 0), which covers
+// exactly the midpoint disc.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+class PolygonFiller {
+  public:
+    // Calls emit(y, xLeft, xRight) for every span of the polygon with
+    // vertices (xs[i], ys[i]), i < n. Self-intersecting polygons and holes
+    // follow the even-odd rule.
+    template <class SpanFn>
+    void fill(const float* xs, const float* ys, int n, SpanFn emit) {
+        const float eps = 1e-4f;
+        edges.clear();
+        for (int i = 0; i < n; ++i) {
+            float xa = xs[i], ya = ys[i];
+            float xb = xs[(i + 1) % n], yb = ys[(i + 1) % n];
+            if (ya > yb) {
+                std::swap(xa, xb);
+                std::swap(ya, yb);
+            }
+            // Rows y with ya <= y < yb; horizontal edges have none.
+            int first = (int)std::ceil(ya - eps);
+            int last = (int)std::ceil(yb - eps) - 1;
+            if (first > last)
+                continue;
+            double slope = ((double)xb - xa) / ((double)yb - ya);
+            edges.push_back({first, last, xa, ya, slope, 0});
+        }
+        if (edges.empty())
+            return;
+        std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+            return a.first < b.first;
+        });
+
+        active.clear();
+        size_t next = 0;
+        int y = edges[0].first;
+        while (next < edges.size() || !active.empty()) {
+            if (active.empty())
+                y = std::max(y, edges[next].first);
+            while (next < edges.size() && edges[next].first == y)
+                active.push_back(edges[next++]);
+            // Drop finished edges and intersect the rest with row y.
+            size_t kept = 0;
+            for (size_t i = 0; i < active.size(); ++i) {
+                if (active[i].last < y)
+                    continue;
+                Edge& e = active[i];
+                e.x = e.xa + (y - e.ya) * e.slope;
+                active[kept++] = e;
+            }
+            active.resize(kept);
+            for (size_t i = 1; i < active.size(); ++i) {
+                Edge e = active[i];
+                size_t j = i;
+                for (; j > 0 && active[j - 1].x > e.x; --j)
+                    active[j] = active[j - 1];
+                active[j] = e;
+            }
+            for (size_t i = 0; i + 1 < active.size(); i += 2) {
+                int x0 = (int)std::ceil(active[i].x - eps);
+                int x1 = (int)std::ceil(active[i + 1].x - eps) - 1;
+                if (x0 <= x1)
+                    emit(y, x0, x1);
+            }
+            ++y;
+        }
+    }
+
+  private:
+    struct Edge {
+        int first, last;       // Rows crossed
+        double xa, ya, slope;  // Lower end and dx / dy
+        double x;              // Crossing on the current row
+    };
+    std::vector<Edge> edges;  // Edge table, sorted by first row
+    std::vector<Edge> active; // Reused between fills
+};
+
+// Even-odd test with the same sampling rule as PolygonFiller::fill.
+inline bool insidePolygon(const float* xs, const float* ys, int n, int x,
+                          int y) {
+    const float eps = 1e-4f;
+    bool in = false;
+    for (int i = 0; i < n; ++i) {
+        float xa = xs[i], ya = ys[i];
+        float xb = xs[(i + 1) % n], yb = ys[(i + 1) % n];
+        if (ya > yb) {
+            std::swap(xa, xb);
+            std::swap(ya, yb);
+        }
+        if (y < (int)std::ceil(ya - eps) || y > (int)std::ceil(yb - eps) - 1)
+            continue;
+        double slope = ((double)xb - xa) / ((double)yb - ya);
+        double cx = xa + (y - ya) * slope;
+        if (x >= (int)std::ceil(cx - eps))
+            in = !in;
+    }
+    return in;
+}
+
+#endif // COMMON_POLYGON_FILL_H
@@ -0,0 +1,96 @@
+#ifndef COMMON_RING_H
+#define COMMON_RING_H
+
+// Thick midpoint-circle rings as horizontal spans. The midpoint algorithm is
+// run once for the outer radius and once for the inner one. Each row of the
+// ring is then the gap between the two circles: at most two spans per row
+// and no per-pixel work.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// y plotted by the midpoint circle (d = 1 - r) at column x of the first
+// octant: the largest y with y * (y - 1) < r^2 - x^2. Lets a walk start in
+// the middle of an octant with exactly the pixels the full loop would give.
+inline int midpointY(int r, int x) {
+    long long m = (long long)r * r - (long long)x * x;
+    int y = (int)((1.0 + std::sqrt(4.0 * (double)m + 1.0)) * 0.5);
+    while (y > 0 && (long long)y * (y - 1) >= m)
+        --y;
+    while ((long long)(y + 1) * y < m)
+        ++y;
+    return y;
+}
+
+// Last column of the first octant (the midpoint loop runs while x <= y).
+inline int midpointOctantEnd(int r) {
+    int lastX = (int)(r * 0.70710678118654752);
+    while (midpointY(r, lastX + 1) >= lastX + 1)
+        ++lastX;
+    while (lastX > 0 && midpointY(r, lastX) < lastX)
+        --lastX;
+    return lastX;
+}
+
+// ext[y] = rightmost x the midpoint circle of radius r plots on row y, for
+// y in 0..r, i.e. the half-width of the filled midpoint disc on that row.
+inline void midpointExtents(int r, std::vector<int>& ext) {
+    ext.assign(r + 1, 0);
+    int x = 0, y = r;
+    int d = 1 - r;
+    while (x <= y) {
+        ext[y] = std::max(ext[y], x);
+        ext[x] = std::max(ext[x], y);
+        if (d < 0) {
+            d += (x << 1) + 3;
+        } else {
+            d += ((x - y) << 1) + 5;
+            --y;
+        }
+        ++x;
+    }
+}
+
+// Calls emit(y, xLeft, xRight) for every span of the ring made of the
+// midpoint circles with radius rInner..rOuter around (cx, cy).
+// rInner == rOuter gives a one-pixel ring. The row extents live in the
+// filler and are reused between calls, so keep one per caller (or thread).
+class RingFiller {
+  public:
+    template <class SpanFn>
+    void fill(int cx, int cy, int rInner, int rOuter, SpanFn emit) {
+        if (rOuter < 0)
+            return;
+        rInner = std::max(0, std::min(rInner, rOuter));
+        midpointExtents(rOuter, outer);
+        int hole = rInner - 1; // Radius of the disc cut out of the middle
+        if (hole >= 0)
+            midpointExtents(hole, inner);
+
+        for (int dy = -rOuter; dy <= rOuter; ++dy) {
+            int a = dy < 0 ? -dy : dy;
+            int xo = outer[a];
+            if (hole >= 0 && a <= hole) {
+                int xi = inner[a];
+                if (xi < xo) {
+                    emit(cy + dy, cx - xo, cx - xi - 1);
+                    emit(cy + dy, cx + xi + 1, cx + xo);
+                }
+            } else {
+                emit(cy + dy, cx - xo, cx + xo);
+            }
+        }
+    }
+
+  private:
+    std::vector<int> outer, inner;
+};
+
+// One-off ring with its own scratch.
+template <class SpanFn>
+void ringSpans(int cx, int cy, int rInner, int rOuter, SpanFn emit) {
+    RingFiller().fill(cx, cy, rInner, rOuter, emit);
+}
+
+#endif // COMMON_RING_H
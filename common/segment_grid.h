@@ -0,0 +1,158 @@
+#ifndef COMMON_SEGMENT_GRID_H
+#define COMMON_SEGMENT_GRID_H
+
+// Uniform grid over the bounding boxes of line segments, so a clip window
+// only looks at the segments near it. A segment whose box fits in one cell
+// is stored in that cell's local list; a longer one is stored in every
+// cell its box overlaps. A query then handles three cases:
+//   - cells fully inside the window: their local segments are accepted
+//     whole (t = 0..1) without any test;
+//   - cells on the window border: local segments are accepted whole when
+//     their box is inside and clipped when it only overlaps;
+//   - long segments are tested the same way, once each.
+// Only the clipped ones go through liangBarskyBatch(). The cost follows the
+// cells and segments under the window, not the total segment count.
+//
+// Accepted segments and intervals match liangBarsky(). The one exception is
+// a segment that only touches the window after rounding: the grid skips
+// it, while the clipper can return a zero-length piece.
+
+#include "clip_batch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class SegmentGrid {
+  public:
+    // The grid covers the given rectangle; segments outside it land in the
+    // border cells, so they are still found, just less selectively.
+    SegmentGrid(float xmin, float ymin, float xmax, float ymax, int cellsX,
+                int cellsY)
+        : x0(xmin), y0(ymin), nx(cellsX), ny(cellsY),
+          sx(cellsX / (xmax - xmin)), sy(cellsY / (ymax - ymin)),
+          local(cellsX * cellsY), spanning(cellsX * cellsY) {}
+
+    size_t size() const { return boxes.size(); }
+
+    void clear() {
+        boxes.clear();
+        seen.clear();
+        for (auto& c : local)
+            c.clear();
+        for (auto& c : spanning)
+            c.clear();
+    }
+
+    // Adds segments size()..s.size()-1 of s, with ids equal to their index.
+    void insertFrom(const SegmentSoA& s) {
+        for (size_t i = boxes.size(); i < s.size(); ++i) {
+            Box b = {std::min(s.x0[i], s.x1[i]), std::min(s.y0[i], s.y1[i]),
+                     std::max(s.x0[i], s.x1[i]), std::max(s.y0[i], s.y1[i])};
+            boxes.push_back(b);
+            seen.push_back(0);
+            int cx0 = cellX(b.xmin), cx1 = cellX(b.xmax);
+            int cy0 = cellY(b.ymin), cy1 = cellY(b.ymax);
+            if (cx0 == cx1 && cy0 == cy1) {
+                local[cy0 * nx + cx0].push_back((uint32_t)i);
+                continue;
+            }
+            for (int cy = cy0; cy <= cy1; ++cy)
+                for (int cx = cx0; cx <= cx1; ++cx)
+                    spanning[cy * nx + cx].push_back((uint32_t)i);
+        }
+    }
+
+    // Clips the segments near w (s must be the SoA the grid was built from)
+    // and returns the accepted ones, in no particular order.
+    void clip(const SegmentSoA& s, const ClipWindow& w, ClippedSegments& out) {
+        out.clear();
+        pending.clear();
+        if (++generation == 0) {
+            std::fill(seen.begin(), seen.end(), 0u);
+            generation = 1;
+        }
+        int cx0 = cellX(w.xmin), cx1 = cellX(w.xmax);
+        int cy0 = cellY(w.ymin), cy1 = cellY(w.ymax);
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const std::vector<uint32_t>& cell = local[cy * nx + cx];
+                // Cells strictly between the window's edge cells only
+                // hold points inside the window.
+                bool inside = cx > cx0 && cx < cx1 && cy > cy0 && cy < cy1;
+                if (inside) {
+                    for (uint32_t id : cell)
+                        accept(out, id);
+                } else {
+                    for (uint32_t id : cell)
+                        classify(w, id, out);
+                }
+                for (uint32_t id : spanning[cy * nx + cx]) {
+                    if (seen[id] != generation) {
+                        seen[id] = generation;
+                        classify(w, id, out);
+                    }
+                }
+            }
+        }
+
+        // Segments crossing the window border, clipped as one batch.
+        batch.clear();
+        for (uint32_t id : pending)
+            batch.push(s.x0[id], s.y0[id], s.x1[id], s.y1[id]);
+        liangBarskyBatch(batch, w, clipped);
+        clipped.forEachAccepted([&](size_t k) {
+            out.id.push_back(pending[k]);
+            out.t0.push_back(clipped.t0[k]);
+            out.t1.push_back(clipped.t1[k]);
+        });
+    }
+
+  private:
+    struct Box {
+        float xmin, ymin, xmax, ymax;
+    };
+
+    int cellX(float x) const {
+        int c = (int)std::floor((x - x0) * sx);
+        return std::max(0, std::min(nx - 1, c));
+    }
+    int cellY(float y) const {
+        int c = (int)std::floor((y - y0) * sy);
+        return std::max(0, std::min(ny - 1, c));
+    }
+
+    void accept(ClippedSegments& out, uint32_t id) const {
+        out.id.push_back(id);
+        out.t0.push_back(0.0f);
+        out.t1.push_back(1.0f);
+    }
+
+    // Whole, skipped, or queued for clipping, by the segment's box.
+    void classify(const ClipWindow& w, uint32_t id, ClippedSegments& out) {
+        const Box& b = boxes[id];
+        if (b.xmax < w.xmin || b.xmin > w.xmax || b.ymax < w.ymin ||
+            b.ymin > w.ymax)
+            return;
+        if (b.xmin >= w.xmin && b.xmax <= w.xmax && b.ymin >= w.ymin &&
+            b.ymax <= w.ymax)
+            accept(out, id);
+        else
+            pending.push_back(id);
+    }
+
+    float x0, y0;
+    int nx, ny;
+    float sx, sy; // Cells per unit
+    std::vector<std::vector<uint32_t>> local, spanning;
+    std::vector<Box> boxes;
+    std::vector<uint32_t> seen; // Query generation that last saw a segment
+    uint32_t generation = 0;
+
+    // Scratch reused between queries
+    std::vector<uint32_t> pending;
+    SegmentSoA batch;
+    ClipIntervals clipped;
+};
+
+#endif // COMMON_SEGMENT_GRID_H
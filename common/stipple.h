@@ -0,0 +1,167 @@
+#ifndef COMMON_STIPPLE_H
+#define COMMON_STIPPLE_H
+
+// Stippled / dashed midpoint circles. The pattern is laid along the true arc
+// length of the circle, so the dot spacing is the same in every octant and
+// for every radius. Only the "on" runs of the pattern are visited: each run
+// jumps straight to its first pixel, so the cost is proportional to the
+// pixels drawn, not to the full perimeter.
+
+#include "ring.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+struct StipplePattern {
+    uint32_t bits = 1;      // Bit i (LSB first) switches cell i on
+    int length = 1;         // Number of cells in one repeat (1..32)
+    float cellLength = 1.f; // Arc length of one cell, in pixels
+    float phase = 0.f;      // Arc length at which the pattern starts
+};
+
+// Calls emit(y, xLeft, xRight) for the visible pixels of the stippled
+// circle, merged into horizontal spans where they share a row.
+template <class SpanFn>
+void stippledCircleSpans(int cx, int cy, int r, const StipplePattern& pat,
+                         SpanFn emit) {
+    const double PI = 3.14159265358979323846, QUARTER_PI = PI / 4.0;
+    if (r <= 0) {
+        if (pat.bits & 1)
+            emit(cy, cx, cx);
+        return;
+    }
+
+    int lastX = midpointOctantEnd(r);
+
+    // "On" runs of one repeat, in cells: [start, end).
+    std::vector<int> runs;
+    int n = pat.length < 1 ? 1 : (pat.length > 32 ? 32 : pat.length);
+    for (int i = 0; i < n;) {
+        if (!((pat.bits >> i) & 1u)) {
+            ++i;
+            continue;
+        }
+        int j = i;
+        while (j < n && ((pat.bits >> j) & 1u))
+            ++j;
+        runs.push_back(i);
+        runs.push_back(j);
+        i = j;
+    }
+    if (runs.empty())
+        return;
+
+    // Pixel (x, y) of the first octant lies before angle phi (measured
+    // clockwise from +y) when x cos(phi) < y sin(phi). No trig per pixel.
+    auto before = [](int x, int y, double c, double s) {
+        return x * c < y * s;
+    };
+
+    // Pending span, so neighbouring pixels on one row go out as one call.
+    bool open = false;
+    int spanY = 0, spanX0 = 0, spanX1 = 0;
+    auto plot = [&](int px, int py) {
+        if (open && py == spanY && px >= spanX0 - 1 && px <= spanX1 + 1) {
+            spanX0 = std::min(spanX0, px);
+            spanX1 = std::max(spanX1, px);
+            return;
+        }
+        if (open)
+            emit(spanY, spanX0, spanX1);
+        open = true;
+        spanY = py;
+        spanX0 = spanX1 = px;
+    };
+
+    // Walks the first-octant columns whose angle lies in [lo, hi) and maps
+    // them into octant k. The 45 degree end is closed so the diagonal pixel
+    // is not lost between two octants. With `force`, at least the first
+    // pixel is plotted, so short dashes never vanish where pixels are
+    // further apart than one cell. Returns the number of pixels plotted.
+    auto octantRun = [&](int k, double lo, double hi, bool force) {
+        double cLo = std::cos(lo), sLo = std::sin(lo);
+        double cHi = std::cos(hi), sHi = std::sin(hi);
+        int x = (int)(r * sLo);
+        if (x > lastX)
+            x = lastX;
+        int y = midpointY(r, x);
+        while (x > 0 && !before(x - 1, midpointY(r, x - 1), cLo, sLo))
+            y = midpointY(r, --x);
+        while (x <= lastX && before(x, y, cLo, sLo))
+            y = midpointY(r, ++x);
+        if (x > lastX && force)
+            y = midpointY(r, x = lastX);
+        bool closed = hi >= QUARTER_PI - 1e-12;
+        // Midpoint decision, in 64 bits: r * r overflows int above 46340
+        long long d = (long long)(x + 1) * (x + 1) + (long long)y * y - y -
+                      (long long)r * r;
+        int plotted = 0;
+        while (x <= lastX &&
+               (closed || before(x, y, cHi, sHi) || (force && plotted == 0))) {
+            switch (k) {
+            case 0: plot(cx + x, cy + y); break;
+            case 1: plot(cx + y, cy + x); break;
+            case 2: plot(cx + y, cy - x); break;
+            case 3: plot(cx + x, cy - y); break;
+            case 4: plot(cx - x, cy - y); break;
+            case 5: plot(cx - y, cy - x); break;
+            case 6: plot(cx - y, cy + x); break;
+            default: plot(cx - x, cy + y); break;
+            }
+            if (d < 0) {
+                d += (x << 1) + 3;
+            } else {
+                d += 2 * (x - y) + 5;
+                --y;
+            }
+            ++x;
+            ++plotted;
+        }
+        return plotted;
+    };
+
+    double circumference = 2.0 * PI * r;
+    double period = n * (double)pat.cellLength;
+    if (period <= 0.0)
+        return;
+    // First repeat whose end reaches arc length 0.
+    double first = std::floor(-pat.phase / period) - 1.0;
+    for (double k = first;; k += 1.0) {
+        double base = pat.phase + k * period;
+        if (base >= circumference)
+            break;
+        for (size_t i = 0; i < runs.size(); i += 2) {
+            double s0 = std::max(0.0, base + runs[i] * (double)pat.cellLength);
+            double s1 = std::min(circumference,
+                                 base + runs[i + 1] * (double)pat.cellLength);
+            if (s0 >= s1)
+                continue;
+            double a0 = s0 / r, a1 = s1 / r; // Angles, clockwise from +y
+            int kFirst = std::min(7, (int)(a0 / QUARTER_PI));
+            int kLast = std::min(7, (int)(a1 / QUARTER_PI));
+            int plotted = 0;
+            for (int pass = 0; pass < 2 && plotted == 0; ++pass) {
+                bool force = pass == 1; // Nothing hit a pixel centre
+                for (int oct = kFirst; oct <= (force ? kFirst : kLast); ++oct) {
+                    double lo = std::max(a0, oct * QUARTER_PI);
+                    double hi = std::min(a1, (oct + 1) * QUARTER_PI);
+                    if (lo >= hi)
+                        continue;
+                    if (oct % 2 == 0) // Angle grows with x
+                        plotted += octantRun(oct, lo - oct * QUARTER_PI,
+                                             hi - oct * QUARTER_PI, force);
+                    else // Mirrored octant: angle shrinks as x grows
+                        plotted += octantRun(oct, (oct + 1) * QUARTER_PI - hi,
+                                             (oct + 1) * QUARTER_PI - lo,
+                                             force);
+                }
+            }
+        }
+    }
+    if (open)
+        emit(spanY, spanX0, spanX1);
+}
+
+#endif // COMMON_STIPPLE_H
@@ -0,0 +1,85 @@
+#ifndef COMMON_THICK_LINE_H
+#define COMMON_THICK_LINE_H
+
+// Thick lines rasterized as the quad around the centre line, one horizontal
+// span per scanline. The cost grows with the covered area rather than with
+// width x length, and there is no overdraw and no gaps on diagonals.
+
+#include "framebuffer.h"
+
+#include <cmath>
+
+// Calls emit(y, xLeft, xRight) once per covered row of a convex polygon.
+// Pixel (x, y) is covered when its centre lies inside the polygon, with the
+// usual half-open rule (left/bottom edges in, right/top edges out) so that
+// polygons sharing an edge never draw the same pixel twice.
+template <class SpanFn>
+void convexPolygonSpans(const float* xs, const float* ys, int n, SpanFn emit) {
+    float minY = ys[0], maxY = ys[0];
+    for (int i = 1; i < n; ++i) {
+        minY = std::min(minY, ys[i]);
+        maxY = std::max(maxY, ys[i]);
+    }
+    const float eps = 1e-4f;
+    int yStart = (int)std::ceil(minY - eps);
+    int yEnd = (int)std::ceil(maxY - eps) - 1;
+    for (int y = yStart; y <= yEnd; ++y) {
+        float left = 1e30f, right = -1e30f;
+        for (int i = 0; i < n; ++i) {
+            float xa = xs[i], ya = ys[i];
+            float xb = xs[(i + 1) % n], yb = ys[(i + 1) % n];
+            if ((y < ya - eps && y < yb - eps) ||
+                (y > ya + eps && y > yb + eps))
+                continue;
+            if (std::fabs(yb - ya) < eps) { // Edge lies on this row
+                left = std::min(left, std::min(xa, xb));
+                right = std::max(right, std::max(xa, xb));
+                continue;
+            }
+            float t = (y - ya) / (yb - ya);
+            t = t < 0.f ? 0.f : (t > 1.f ? 1.f : t);
+            float x = xa + t * (xb - xa);
+            left = std::min(left, x);
+            right = std::max(right, x);
+        }
+        int x0 = (int)std::ceil(left - eps);
+        int x1 = (int)std::ceil(right - eps) - 1;
+        if (x0 <= x1)
+            emit(y, x0, x1);
+    }
+}
+
+// Spans of a line of width w (measured across the line) from (x1, y1) to
+// (x2, y2). The quad extends half a pixel past both endpoints so that, like
+// Bresenham, the endpoint pixels are always covered.
+template <class SpanFn>
+void thickLineSpans(int x1, int y1, int x2, int y2, int w, SpanFn emit) {
+    float half = (w < 1 ? 1 : w) * 0.5f;
+    float dx = (float)(x2 - x1), dy = (float)(y2 - y1);
+    float len = std::sqrt(dx * dx + dy * dy);
+    float ux = 1.f, uy = 0.f; // Unit direction; a point becomes a square
+    if (len > 1e-6f) {
+        ux = dx / len;
+        uy = dy / len;
+    }
+    float ax = ux * 0.5f, ay = uy * 0.5f; // Endpoint extension
+    float nx = -uy * half, ny = ux * half; // Half-width normal
+    float xs[4] = {x1 - ax + nx, x2 + ax + nx, x2 + ax - nx, x1 - ax - nx};
+    float ys[4] = {y1 - ay + ny, y2 + ay + ny, y2 + ay - ny, y1 - ay - ny};
+    if (len <= 1e-6f) {
+        float h = half > 0.5f ? half : 0.5f;
+        xs[0] = xs[3] = x1 - h;
+        xs[1] = xs[2] = x1 + h;
+        ys[0] = ys[1] = y1 + h;
+        ys[2] = ys[3] = y1 - h;
+    }
+    convexPolygonSpans(xs, ys, 4, emit);
+}
+
+inline void drawThickLine(Framebuffer& fb, int x1, int y1, int x2, int y2,
+                          int w) {
+    thickLineSpans(x1, y1, x2, y2, w,
+                   [&](int y, int xa, int xb) { fb.fillSpan(y, xa, xb); });
+}
+
+#endif // COMMON_THICK_LINE_H
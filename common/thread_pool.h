@@ -0,0 +1,104 @@
+#ifndef COMMON_THREAD_POOL_H
+#define COMMON_THREAD_POOL_H
+
+// Small persistent worker pool. parallelFor() hands out indices through an
+// atomic counter. The calling thread works too, and the call returns when
+// every index is done.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+  public:
+    // threads = 0 uses one thread per core (the caller counts as one).
+    explicit ThreadPool(unsigned threads = 0) {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 1; i < threads; ++i)
+            workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers)
+            t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return (unsigned)workers.size() + 1; }
+
+    void parallelFor(int count, const std::function<void(int)>& fn) {
+        if (workers.empty() || count <= 1) {
+            for (int i = 0; i < count; ++i)
+                fn(i);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lk(m);
+            job = &fn;
+            jobCount = count;
+            next = 0;
+            ++generation;
+        }
+        wake.notify_all();
+        runJob(&fn, count);
+        std::unique_lock<std::mutex> lk(m);
+        done.wait(lk, [this] { return busy == 0; });
+        job = nullptr;
+    }
+
+  private:
+    void runJob(const std::function<void(int)>* fn, int count) {
+        for (int i = next++; i < count; i = next++)
+            (*fn)(i);
+    }
+
+    void workerLoop() {
+        unsigned long seen = 0;
+        for (;;) {
+            std::unique_lock<std::mutex> lk(m);
+            wake.wait(lk, [&] { return stop || generation != seen; });
+            if (stop)
+                return;
+            seen = generation;
+            const std::function<void(int)>* fn = job;
+            int count = jobCount;
+            ++busy;
+            lk.unlock();
+            if (fn)
+                runJob(fn, count);
+            lk.lock();
+            if (--busy == 0)
+                done.notify_all();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex m;
+    std::condition_variable wake, done;
+    const std::function<void(int)>* job = nullptr;
+    int jobCount = 0;
+    std::atomic<int> next{0};
+    int busy = 0;
+    unsigned long generation = 0;
+    bool stop = false;
+};
+
+// Shared pool for programs that do not manage their own.
+inline ThreadPool& defaultThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+#endif // COMMON_THREAD_POOL_H
@@ -0,0 +1,304 @@
+#ifndef COMMON_TILE_RASTER_H
+#define COMMON_TILE_RASTER_H
+
+// Tile-binned parallel rasterizer for Bresenham lines and midpoint circles.
+// Primitives are queued, binned into the screen tiles they touch, and then
+// tiles are rasterized in parallel. Each tile only writes its own pixels, in
+// submission order, so the image is identical to drawing the primitives one
+// by one on a single thread.
+//
+// Lines and circles can start mid-way because the Bresenham minor axis and
+// the midpoint circle y both have closed forms. A tile only visits the steps
+// that land inside it, on both of its axes. With a one-thread pool there is
+// nothing to split, so flush() draws the primitives directly.
+
+#include "framebuffer.h"
+#include "ring.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+struct TilePrimitive {
+    enum Kind { LINE, CIRCLE } kind;
+    // Line: x1, y1, x2, y2. Circle: cx, cy, r, and midpointOctantEnd(r) once
+    // binning finds it spans several tiles (-1 until then).
+    int a, b, c, d;
+    uint32_t color;
+};
+
+// Pixel rectangle [x0, x1] x [y0, y1] a tile may write to.
+struct TileRect {
+    int x0, y0, x1, y1;
+};
+
+// Same pixels as Framebuffer::drawLine, limited to `clip`. Along the major
+// axis step k, the minor offset is floor((2k*dMinor + dMajor - 1) /
+// (2*dMajor)), which is exactly what the error-term walk produces.
+inline void rasterLineClipped(Framebuffer& fb, const TileRect& clip, int x1,
+                              int y1, int x2, int y2, uint32_t color) {
+    int dx = std::abs(x2 - x1), dy = std::abs(y2 - y1);
+    int sx = (x1 < x2) ? 1 : -1;
+    int sy = (y1 < y2) ? 1 : -1;
+    bool xMajor = dx >= dy;
+    int dMaj = xMajor ? dx : dy, dMin = xMajor ? dy : dx;
+    int maj0 = xMajor ? x1 : y1, min0 = xMajor ? y1 : x1;
+    int sMaj = xMajor ? sx : sy, sMin = xMajor ? sy : sx;
+    int lo = xMajor ? clip.x0 : clip.y0, hi = xMajor ? clip.x1 : clip.y1;
+    int minLo = xMajor ? clip.y0 : clip.x0, minHi = xMajor ? clip.y1 : clip.x1;
+
+    // Steps k whose major coordinate maj0 + k * sMaj lies in [lo, hi].
+    int kA = (lo - maj0) * sMaj, kB = (hi - maj0) * sMaj;
+    int kStart = std::max(0, std::min(kA, kB));
+    int kEnd = std::min(dMaj, std::max(kA, kB));
+    if (kStart > kEnd)
+        return;
+
+    long long twoMaj = 2LL * dMaj;
+    long long num = 2LL * kStart * dMin + dMaj - 1;
+    long long j = dMaj ? num / twoMaj : 0;
+    for (int k = kStart; k <= kEnd; ++k) {
+        int mi = min0 + (int)j * sMin;
+        if (mi >= minLo && mi <= minHi) {
+            int ma = maj0 + k * sMaj;
+            if (xMajor)
+                fb.set(ma, mi, color);
+            else
+                fb.set(mi, ma, color);
+        }
+        num += 2LL * dMin;
+        if (num >= (j + 1) * twoMaj)
+            ++j;
+    }
+}
+
+// Smallest x >= 0 with x * x >= n.
+inline int ceilSqrt(long long n) {
+    if (n <= 0)
+        return 0;
+    long long x = (long long)std::sqrt((double)n);
+    while (x * x < n)
+        ++x;
+    while (x > 0 && (x - 1) * (x - 1) >= n)
+        --x;
+    return (int)x;
+}
+
+// Same pixels as the 8-way midpoint circle (d = 1 - r), limited to `clip`.
+// lastX is midpointOctantEnd(r) if the caller already has it, or -1.
+inline void rasterCircleClipped(Framebuffer& fb, const TileRect& clip, int cx,
+                                int cy, int r, int lastX, uint32_t color) {
+    if (r < 0)
+        return;
+    if (cx - r >= clip.x0 && cx + r <= clip.x1 && cy - r >= clip.y0 &&
+        cy + r <= clip.y1) {
+        // Whole circle in the tile: the plain loop, nothing to clip.
+        int x = 0, y = r, d = 1 - r;
+        while (x <= y) {
+            fb.set(cx + x, cy + y, color);
+            fb.set(cx - x, cy + y, color);
+            fb.set(cx + x, cy - y, color);
+            fb.set(cx - x, cy - y, color);
+            fb.set(cx + y, cy + x, color);
+            fb.set(cx - y, cy + x, color);
+            fb.set(cx + y, cy - x, color);
+            fb.set(cx - y, cy - x, color);
+            if (d < 0) {
+                d += (x << 1) + 3;
+            } else {
+                d += 2 * (x - y) + 5;
+                --y;
+            }
+            ++x;
+        }
+        return;
+    }
+    if (lastX < 0)
+        lastX = midpointOctantEnd(r);
+    // Octant k plots (cx + u, cy + v), where u / v are +-x or +-y of the
+    // first octant point (x, y). "swap" means u comes from y.
+    static const int sign[8][2] = {{1, 1},  {1, 1},   {1, -1}, {1, -1},
+                                   {-1, -1}, {-1, -1}, {-1, 1}, {-1, 1}};
+    static const bool swapXY[8] = {false, true, true, false,
+                                   false, true, true, false};
+    long long rr = (long long)r * r;
+    for (int k = 0; k < 8; ++k) {
+        int su = sign[k][0], sv = sign[k][1];
+        // Offsets along the screen axes that carry x and y.
+        long long xa, xb, ya, yb;
+        if (!swapXY[k]) {
+            xa = (long long)(clip.x0 - cx) * su;
+            xb = (long long)(clip.x1 - cx) * su;
+            ya = (long long)(clip.y0 - cy) * sv;
+            yb = (long long)(clip.y1 - cy) * sv;
+        } else {
+            xa = (long long)(clip.y0 - cy) * sv;
+            xb = (long long)(clip.y1 - cy) * sv;
+            ya = (long long)(clip.x0 - cx) * su;
+            yb = (long long)(clip.x1 - cx) * su;
+        }
+        long long xStart = std::max(0LL, std::min(xa, xb));
+        long long xEnd = std::min((long long)lastX, std::max(xa, xb));
+        long long yLo = std::min(ya, yb), yHi = std::max(ya, yb);
+        // The octant's y runs from r down to about lastX.
+        if (xStart > xEnd || yHi < lastX || yLo > r)
+            continue;
+        // y = midpointY(r, x) never increases, and midpointY(r, x) <= Y
+        // exactly when x * x >= r * r - Y * (Y + 1), so the columns that
+        // land on rows yLo..yHi are one range of x.
+        if (yHi < r)
+            xStart = std::max(xStart,
+                              (long long)ceilSqrt(rr - yHi * (yHi + 1)));
+        if (yLo > 0)
+            xEnd = std::min(xEnd,
+                            (long long)ceilSqrt(rr - yLo * (yLo - 1)) - 1);
+        if (xStart > xEnd)
+            continue;
+        // Walk a pixel index: one screen axis moves every column, the other
+        // only when y drops.
+        int y = midpointY(r, (int)xStart);
+        long long d = (xStart + 1) * (xStart + 1) + (long long)y * y - y - rr;
+        ptrdiff_t stepU = su, stepV = (ptrdiff_t)sv * fb.width;
+        ptrdiff_t stepX = swapXY[k] ? stepV : stepU;
+        ptrdiff_t stepY = swapXY[k] ? -stepU : -stepV;
+        ptrdiff_t at = (ptrdiff_t)cy * fb.width + cx + stepX * xStart -
+                       stepY * y;
+        uint32_t* pixels = fb.pixels.data();
+        for (int x = (int)xStart; x <= (int)xEnd; ++x) {
+            pixels[at] = color;
+            // Written as selects: d's sign flips too irregularly to predict.
+            bool drop = d >= 0;
+            d += drop ? 2 * (x - y) + 5 : (x << 1) + 3;
+            y -= drop;
+            at += stepX + (drop ? stepY : 0);
+        }
+    }
+}
+
+class TileRasterizer {
+  public:
+    explicit TileRasterizer(int tileSize = 64) : tile(tileSize) {}
+
+    void line(int x1, int y1, int x2, int y2, uint32_t color) {
+        prims.push_back({TilePrimitive::LINE, x1, y1, x2, y2, color});
+    }
+    void circle(int cx, int cy, int r, uint32_t color) {
+        prims.push_back({TilePrimitive::CIRCLE, cx, cy, r, -1, color});
+    }
+    size_t pending() const { return prims.size(); }
+
+    // Bins and rasterizes everything queued so far, then clears the queue.
+    void flush(Framebuffer& fb, ThreadPool& pool = defaultThreadPool()) {
+        if (prims.empty())
+            return;
+        // A single thread gains nothing from tiles, so skip the binning and
+        // draw everything in order, clipped to the framebuffer.
+        if (pool.size() == 1) {
+            TileRect all = {0, 0, fb.width - 1, fb.height - 1};
+            for (const TilePrimitive& p : prims)
+                draw(fb, all, p);
+            prims.clear();
+            return;
+        }
+        tilesX = (fb.width + tile - 1) / tile;
+        tilesY = (fb.height + tile - 1) / tile;
+        bins.resize((size_t)tilesX * tilesY);
+        for (auto& b : bins)
+            b.clear();
+        for (size_t i = 0; i < prims.size(); ++i)
+            bin(prims[i], (int)i, fb);
+
+        pool.parallelFor((int)bins.size(), [&](int t) {
+            const std::vector<int>& list = bins[t];
+            if (list.empty())
+                return;
+            int tx = t % tilesX, ty = t / tilesX;
+            TileRect clip = {tx * tile, ty * tile,
+                             std::min(fb.width, (tx + 1) * tile) - 1,
+                             std::min(fb.height, (ty + 1) * tile) - 1};
+            for (int idx : list)
+                draw(fb, clip, prims[idx]);
+        });
+        prims.clear();
+    }
+
+  private:
+    static void draw(Framebuffer& fb, const TileRect& clip,
+                     const TilePrimitive& p) {
+        if (p.kind == TilePrimitive::LINE)
+            rasterLineClipped(fb, clip, p.a, p.b, p.c, p.d, p.color);
+        else
+            rasterCircleClipped(fb, clip, p.a, p.b, p.c, p.d, p.color);
+    }
+
+    // Adds the primitive to every tile its pixels can reach: tiles near the
+    // line, or tiles the circle's outline passes through.
+    void bin(TilePrimitive& p, int index, const Framebuffer& fb) {
+        int bx0, by0, bx1, by1;
+        if (p.kind == TilePrimitive::LINE) {
+            bx0 = std::min(p.a, p.c);
+            bx1 = std::max(p.a, p.c);
+            by0 = std::min(p.b, p.d);
+            by1 = std::max(p.b, p.d);
+        } else {
+            bx0 = p.a - p.c;
+            bx1 = p.a + p.c;
+            by0 = p.b - p.c;
+            by1 = p.b + p.c;
+        }
+        int tx0 = std::max(0, bx0 / tile), tx1 = std::min(tilesX - 1, bx1 / tile);
+        int ty0 = std::max(0, by0 / tile), ty1 = std::min(tilesY - 1, by1 / tile);
+        if (bx1 < 0 || by1 < 0 || bx0 >= fb.width || by0 >= fb.height)
+            return;
+        // Every tile a circle reaches walks from the same octant end.
+        if (p.kind == TilePrimitive::CIRCLE && p.c >= 0 &&
+            (tx0 != tx1 || ty0 != ty1))
+            p.d = midpointOctantEnd(p.c);
+
+        // Line: distance from the tile centre to the infinite line.
+        double nx = 0, ny = 0, len = 0;
+        if (p.kind == TilePrimitive::LINE) {
+            nx = -(double)(p.d - p.b);
+            ny = (double)(p.c - p.a);
+            len = std::sqrt(nx * nx + ny * ny);
+        }
+        double reach = tile * 0.70710678 + 1.0; // Half tile diagonal + slack
+
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                double x0 = tx * tile, y0 = ty * tile;
+                double x1 = x0 + tile - 1, y1 = y0 + tile - 1;
+                if (p.kind == TilePrimitive::LINE) {
+                    if (len > 0) {
+                        double cxT = (x0 + x1) * 0.5 - p.a;
+                        double cyT = (y0 + y1) * 0.5 - p.b;
+                        if (std::fabs(cxT * nx + cyT * ny) / len > reach)
+                            continue;
+                    }
+                } else {
+                    // Nearest and farthest tile points from the centre.
+                    double ex = std::max(std::max(x0 - p.a, p.a - x1), 0.0);
+                    double ey = std::max(std::max(y0 - p.b, p.b - y1), 0.0);
+                    double fx = std::max(std::fabs(x0 - p.a), std::fabs(x1 - p.a));
+                    double fy = std::max(std::fabs(y0 - p.b), std::fabs(y1 - p.b));
+                    double r = p.c, inner = std::max(r - 1, 0.0);
+                    if (ex * ex + ey * ey > (r + 1) * (r + 1) ||
+                        fx * fx + fy * fy < inner * inner)
+                        continue;
+                }
+                bins[(size_t)ty * tilesX + tx].push_back(index);
+            }
+        }
+    }
+
+    int tile;
+    int tilesX = 0, tilesY = 0;
+    std::vector<TilePrimitive> prims;
+    std::vector<std::vector<int>> bins;
+};
+
+#endif // COMMON_TILE_RASTER_H
@@ -1,6 +1,7 @@
 #include <GL/glut.h>
 #include <cmath>
 #include <bits/stdc++.h>
+#include "../../common/circle_cache_gl.h"
 using namespace std;
 
 // Screen size
@@ -46,15 +47,7 @@ vector<Circle> circles;
 // Draw a filled circle
 void drawCircle(float x, float y, float radius) {
     const int num_segments = 50;
-    float angle;
-
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(x, y);
-    for (int i = 0; i <= num_segments; i++) {
-        angle = i * 2.0f * 3.141592f / num_segments;
-        glVertex2f(x + cos(angle) * radius, y + sin(angle) * radius);
-    }
-    glEnd();
+    drawCachedCircle(x, y, radius, num_segments);
 }
 
 // Display callback
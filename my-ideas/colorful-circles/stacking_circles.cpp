@@ -1,6 +1,7 @@
 #include <GL/glut.h>
 #include <cmath>
 #include <bits/stdc++.h>
+#include "../../common/circle_cache_gl.h"
 using namespace std;
 
 const int WIDTH = 1000;
@@ -41,13 +42,7 @@ vector<Circle> circles;
 
 void drawCircle(float x, float y, float radius) {
     const int segments = 50;
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(x, y);
-    for (int i = 0; i <= segments; ++i) {
-        float angle = i * 2.0f * 3.14159f / segments;
-        glVertex2f(x + cos(angle) * radius, y + sin(angle) * radius);
-    }
-    glEnd();
+    drawCachedCircle(x, y, radius, segments);
 }
 
 bool isColliding(Circle& a, Circle& b) {
@@ -1,6 +1,8 @@
 #include<bits/stdc++.h>
 #include <GL/glut.h>
 #include <cmath>
+#include "../../common/brush_line.h"
+#include "../../common/line_kernels.h"
 using namespace std;
 
 const int inf = 1e9 + 7;
@@ -45,29 +47,30 @@ void putPixel(int x, int y) {
     glEnd();
 }
 
+// Bold lines sweep a 3x3 brush along the path. Steps only record the
+// covered run of each row, which is drawn once in flushBold().
+BrushStroke boldBrush(1, BRUSH_SQUARE);
+
 void drawPixel(int x, int y, bool bold) {
-    putPixel(x, y);
     if (bold) {
-        putPixel(x + 1, y);
-        putPixel(x - 1, y);
-        putPixel(x, y + 1);
-        putPixel(x, y - 1);
-        putPixel(x + 1, y + 1);
-        putPixel(x - 1, y - 1);
-        putPixel(x + 1, y - 1);
-        putPixel(x - 1, y + 1);
+        boldBrush.addPoint(x, y);
+    } else {
+        putPixel(x, y);
     }
 }
 
-void drawLine(int x1, int y1, int x2, int y2, int iden, bool bold) {
-    int tx1 = x1, ty1 = y1;
-    int dx = abs(x2 - x1);
-    int dy = abs(y2 - y1);
-    int sx = (x2 >= x1) ? 1 : -1;
-    int sy = (y2 >= y1) ? 1 : -1;
-
-    int err = dx - dy;
+void flushBold() {
+    glBegin(GL_QUADS);
+    boldBrush.emitSpans([](int y, int xa, int xb) {
+        glVertex2i(xa, y);
+        glVertex2i(xb + 1, y);
+        glVertex2i(xb + 1, y + 1);
+        glVertex2i(xa, y + 1);
+    });
+    glEnd();
+}
 
+void drawLine(int x1, int y1, int x2, int y2, int iden, bool bold) {
     int barLength;
     int nextBarGap = segGapY;
 //    if (iden) {
@@ -77,7 +80,11 @@ void drawLine(int x1, int y1, int x2, int y2, int iden, bool bold) {
     pair<int, int> mxPointL[2];
     pair<int, int> mxPointR[2] = {{inf, inf}, {inf, inf}};
 
-    while (true) {
+    if (bold) {
+        boldBrush.reset(min(y1, y2), max(y1, y2));
+    }
+
+    bresenhamLine(x1, y1, x2, y2, [&](int tx1, int ty1) {
         drawPixel(tx1, ty1, bold);
 
         if (iden == 1) {
@@ -131,19 +138,9 @@ void drawLine(int x1, int y1, int x2, int y2, int iden, bool bold) {
                 }
             }
         }
-
-        if (tx1 == x2 && ty1 == y2) break;
-
-        int e2 = (err << 1);
-
-        if (e2 > -dy) {
-            err -= dy;
-            tx1 += sx;
-        }
-        if (e2 < dx) {
-            err += dx;
-            ty1 += sy;
-        }
+    });
+    if (bold) {
+        flushBold();
     }
     if (iden == 1) {
         int distance1FromTop = topPoint.second - mxPointL[0].second;
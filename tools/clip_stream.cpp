@@ -0,0 +1,273 @@
+// Streaming Liang-Barsky clipper for segment files too large to load. The
+// input is memory-mapped and clipped in parallel chunks against one or more
+// windows; accepted pieces are streamed to the output file in input order.
+//   g++ -std=c++17 -O2 tools/clip_stream.cpp -o clip_stream -pthread
+//   ./clip_stream in.seg out.clip --window xmin ymin xmax ymax
+//                 [--window ...] [--threads N] [--chunk SEGMENTS]
+//   ./clip_stream --generate COUNT out.seg [--seed S]
+//
+// in.seg: little-endian float32 records x0 y0 x1 y1 (16 bytes each), no
+// header. out.clip: one 32-byte ClipRecord per accepted (segment, window)
+// pair, ordered by segment and then window.
+//
+// Memory stays bounded whatever the input size: a round of chunks (a few
+// per thread) is clipped while the previous round's output is written on
+// a second thread, so at most two rounds of output are held, and input
+// pages are dropped from the mapping once their round is done. POSIX only
+// (mmap).
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../common/clip_batch.h"
+#include "../common/thread_pool.h"
+
+struct SegmentRecord {
+    float x0, y0, x1, y1;
+};
+
+struct ClipRecord {
+    uint64_t segment; // Index in the input file
+    uint32_t window;  // Index of the --window option
+    float x0, y0, x1, y1;
+    uint32_t reserved; // Zero; pads the record to 32 bytes
+};
+static_assert(sizeof(ClipRecord) == 32, "ClipRecord is a file format");
+
+// Per-chunk scratch, reused from round to round.
+struct ChunkWork {
+    SegmentSoA soa;
+    std::vector<ClipIntervals> clipped; // One per window
+    std::vector<ClipRecord> out;
+};
+
+// Clips records [first, first + n) against every window into work.out.
+static void clipChunk(const SegmentRecord* in, uint64_t first, size_t n,
+                      const std::vector<ClipWindow>& windows,
+                      ChunkWork& work) {
+    SegmentSoA& s = work.soa;
+    s.x0.resize(n);
+    s.y0.resize(n);
+    s.x1.resize(n);
+    s.y1.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        s.x0[i] = in[i].x0;
+        s.y0[i] = in[i].y0;
+        s.x1[i] = in[i].x1;
+        s.y1[i] = in[i].y1;
+    }
+    work.out.clear();
+    std::vector<ClipIntervals>& all = work.clipped;
+    all.resize(windows.size());
+    for (size_t w = 0; w < windows.size(); ++w)
+        liangBarskyBatch(s, windows[w], all[w]);
+    if (windows.size() == 1) {
+        const ClipIntervals& c = all[0];
+        c.forEachAccepted([&](size_t i) {
+            float dx = s.x1[i] - s.x0[i], dy = s.y1[i] - s.y0[i];
+            work.out.push_back({first + i, 0, s.x0[i] + c.t0[i] * dx,
+                                s.y0[i] + c.t0[i] * dy, s.x0[i] + c.t1[i] * dx,
+                                s.y0[i] + c.t1[i] * dy, 0});
+        });
+        return;
+    }
+    // Several windows: merge so records stay in (segment, window) order.
+    for (size_t word = 0; word < (n + 63) / 64; ++word) {
+        uint64_t any = 0;
+        for (const ClipIntervals& c : all)
+            any |= c.accept[word];
+        for (; any; any &= any - 1) {
+            size_t i = (word << 6) + __builtin_ctzll(any);
+            float dx = s.x1[i] - s.x0[i], dy = s.y1[i] - s.y0[i];
+            for (size_t w = 0; w < all.size(); ++w) {
+                const ClipIntervals& c = all[w];
+                if (!c.accepted(i))
+                    continue;
+                work.out.push_back({first + i, (uint32_t)w,
+                                    s.x0[i] + c.t0[i] * dx,
+                                    s.y0[i] + c.t0[i] * dy,
+                                    s.x0[i] + c.t1[i] * dx,
+                                    s.y0[i] + c.t1[i] * dy, 0});
+            }
+        }
+    }
+}
+
+static int generate(uint64_t count, const char* path, unsigned seed) {
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pos(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> step(-50.0f, 50.0f);
+    std::vector<SegmentRecord> buf;
+    for (uint64_t done = 0; done < count; done += buf.size()) {
+        buf.resize((size_t)std::min<uint64_t>(count - done, 1 << 16));
+        for (SegmentRecord& r : buf) {
+            r.x0 = pos(rng);
+            r.y0 = pos(rng);
+            r.x1 = r.x0 + step(rng);
+            r.y1 = r.y0 + step(rng);
+        }
+        if (fwrite(buf.data(), sizeof(SegmentRecord), buf.size(), f) !=
+            buf.size()) {
+            fprintf(stderr, "error writing %s\n", path);
+            fclose(f);
+            return 1;
+        }
+    }
+    if (fclose(f) != 0) {
+        fprintf(stderr, "error writing %s\n", path);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::vector<const char*> paths;
+    std::vector<ClipWindow> windows;
+    unsigned threads = 0, seed = 1;
+    size_t chunk = 1 << 14;
+    long long generateCount = -1;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--window") && i + 4 < argc) {
+            float a = atof(argv[i + 1]), b = atof(argv[i + 2]);
+            float c = atof(argv[i + 3]), d = atof(argv[i + 4]);
+            windows.push_back({std::min(a, c), std::min(b, d), std::max(a, c),
+                               std::max(b, d)});
+            i += 4;
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--chunk") && i + 1 < argc) {
+            chunk = std::max(64, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--generate") && i + 1 < argc) {
+            generateCount = atoll(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = atoi(argv[++i]);
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (generateCount >= 0 && paths.size() == 1)
+        return generate(generateCount, paths[0], seed);
+    if (paths.size() != 2 || windows.empty()) {
+        fprintf(stderr, "usage: clip_stream in.seg out.clip --window xmin ymin "
+                        "xmax ymax [--window ...] [--threads N] [--chunk N]\n"
+                        "       clip_stream --generate COUNT out.seg "
+                        "[--seed S]\n");
+        return 2;
+    }
+
+    int fd = open(paths[0], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "cannot open %s\n", paths[0]);
+        if (fd >= 0)
+            close(fd);
+        return 1;
+    }
+    uint64_t count = (uint64_t)st.st_size / sizeof(SegmentRecord);
+    const SegmentRecord* in = nullptr;
+    void* map = nullptr;
+    if (count > 0) {
+        map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            fprintf(stderr, "cannot map %s\n", paths[0]);
+            close(fd);
+            return 1;
+        }
+        madvise(map, st.st_size, MADV_SEQUENTIAL);
+        in = (const SegmentRecord*)map;
+    }
+    FILE* out = fopen(paths[1], "wb");
+    if (!out) {
+        fprintf(stderr, "cannot write %s\n", paths[1]);
+        if (map)
+            munmap(map, st.st_size);
+        close(fd);
+        return 1;
+    }
+    setvbuf(out, nullptr, _IOFBF, 1 << 20);
+
+    ThreadPool pool(threads);
+    const int slots = (int)pool.size() * 4; // Chunks per round
+    std::vector<ChunkWork> work[2] = {std::vector<ChunkWork>(slots),
+                                      std::vector<ChunkWork>(slots)};
+    std::vector<uint64_t> accepted(windows.size(), 0);
+    std::thread writer;
+    bool writeFailed = false;
+    const long pageSize = sysconf(_SC_PAGESIZE);
+
+    auto t0 = std::chrono::steady_clock::now();
+    int set = 0;
+    for (uint64_t roundStart = 0; roundStart < count;
+         roundStart += (uint64_t)slots * chunk, set ^= 1) {
+        std::vector<ChunkWork>& cur = work[set];
+        pool.parallelFor(slots, [&](int k) {
+            uint64_t first = roundStart + (uint64_t)k * chunk;
+            size_t n = first < count
+                           ? (size_t)std::min<uint64_t>(chunk, count - first)
+                           : 0;
+            if (n)
+                clipChunk(in + first, first, n, windows, cur[k]);
+            else
+                cur[k].out.clear();
+        });
+        // Done with these input pages (whole pages only). This must be
+        // madvise(): glibc's posix_madvise() ignores POSIX_MADV_DONTNEED,
+        // and the pages would stay resident until munmap().
+        uint64_t roundEnd = std::min(count, roundStart + (uint64_t)slots * chunk);
+        uint64_t from = roundStart * sizeof(SegmentRecord) / pageSize * pageSize;
+        uint64_t to = roundEnd * sizeof(SegmentRecord) / pageSize * pageSize;
+        if (to > from)
+            madvise((char*)map + from, to - from, MADV_DONTNEED);
+
+        // The previous round's writer must finish before its buffers are
+        // reused next round; this round is written in the background.
+        if (writer.joinable())
+            writer.join();
+        for (const ChunkWork& w : cur)
+            for (const ClipRecord& r : w.out)
+                ++accepted[r.window];
+        writer = std::thread([&cur, out, &writeFailed] {
+            for (const ChunkWork& w : cur)
+                if (fwrite(w.out.data(), sizeof(ClipRecord), w.out.size(),
+                           out) != w.out.size())
+                    writeFailed = true;
+        });
+    }
+    if (writer.joinable())
+        writer.join();
+    if (fclose(out) != 0)
+        writeFailed = true;
+    if (map)
+        munmap(map, st.st_size);
+    close(fd);
+    double sec = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - t0).count();
+
+    fprintf(stderr, "%llu segments, %.3f s, %.1f MB/s in, %u threads\n",
+            (unsigned long long)count, sec,
+            count * sizeof(SegmentRecord) / 1e6 / std::max(sec, 1e-9),
+            pool.size());
+    for (size_t w = 0; w < windows.size(); ++w)
+        fprintf(stderr, "window %zu (%g, %g)-(%g, %g): %llu accepted\n", w,
+                windows[w].xmin, windows[w].ymin, windows[w].xmax,
+                windows[w].ymax, (unsigned long long)accepted[w]);
+    if (writeFailed) {
+        fprintf(stderr, "error writing %s\n", paths[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,247 @@
+// Golden-image regression and timing harness. Runs each program headless
+// with fixed inputs, compares its PNG with the screenshot committed next to
+// the source, and records how long each scene took.
+//
+//   g++ -std=c++17 -O2 tools/golden_harness.cpp -o golden_harness -lpng
+//   ./golden_harness --bin-dir build [--tolerance 3] [--threshold 0.9]
+//                    [--keep out_dir]
+//
+// The programs are expected in --bin-dir, named after their source file
+// without .cpp (see README). Run it from the repository root.
+//
+// The references are window screenshots: they include the console and the
+// title bar, and Windows display scaling enlarged them. Each scene therefore
+// knows its scale and where the client area starts. Pixels are reduced to
+// "ink" (anything that is not the white background), and scenes are
+// compared with a tolerance of a few pixels in both directions:
+//   precision  rendered ink that has reference ink nearby
+//   recall     reference ink that has rendered ink nearby
+// The client origin is refined by searching a few pixels around the given
+// one, since screenshot crops are never exact.
+#include <png.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Scene {
+    const char* name;
+    const char* program; // Binary name in --bin-dir
+    const char* input;   // Fed to stdin
+    const char* args;    // Extra arguments after --headless out.png
+    const char* reference; // nullptr: timing only
+    float scale;           // Reference pixels per framebuffer pixel
+    int originX, originY;  // Client area top-left in the reference
+};
+
+// Inputs are the ones typed in the screenshots.
+static const Scene scenes[] = {
+    {"lab1_dotted_circle", "midpoint_circle_with_dotted_border",
+     "250 350\n100\n", "", "Lab_1/midpoint_circle_with_dotted_border.png",
+     1.5625f, 0, 120},
+    {"lab1_rainbow_circles", "multiple_midpoint_circles_rainbow_colors", "17\n",
+     "", "Lab_1/multiple_midpoint_circles_rainbow_colors.png", 1.25f, -4, 84},
+    {"lab2_bold_line", "bold_line_using_8_neighbour", "100 100\n400 400\n", "",
+     "Lab_2/bold_line_using_8_neighbour.png", 1.25f, 0, 148},
+    // assignment/image.png and Mid_Exam/Mid_Que.png are the question
+    // sheets, not renders, so these two scenes are timed only.
+    {"task1_bresenham", "task_1", "", "1 -30 -40 70 20", nullptr, 1, 0, 0},
+    {"task1_thick_line", "task_1", "", "2 -60 -20 80 50 9", nullptr, 1, 0, 0},
+    {"mid_que1_flood_fill", "Que_1", "", "250 320", nullptr, 1, 0, 0},
+};
+
+struct Image {
+    int width = 0, height = 0;
+    std::vector<uint32_t> pixels; // RGBA8, top row first
+};
+
+static bool readPng(const std::string& path, Image& img) {
+    png_image png;
+    memset(&png, 0, sizeof png);
+    png.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_file(&png, path.c_str()))
+        return false;
+    png.format = PNG_FORMAT_RGBA;
+    img.width = png.width;
+    img.height = png.height;
+    img.pixels.resize((size_t)png.width * png.height);
+    if (!png_image_finish_read(&png, nullptr, img.pixels.data(), 0, nullptr)) {
+        png_image_free(&png);
+        return false;
+    }
+    return true;
+}
+
+// Anything visibly different from the white background.
+static std::vector<uint8_t> inkMask(const Image& img) {
+    std::vector<uint8_t> ink(img.pixels.size());
+    for (size_t i = 0; i < ink.size(); ++i) {
+        uint32_t c = img.pixels[i];
+        int r = c & 0xFF, g = (c >> 8) & 0xFF, b = (c >> 16) & 0xFF;
+        ink[i] = (255 - r > 60 || 255 - g > 60 || 255 - b > 60);
+    }
+    return ink;
+}
+
+// Square dilation by `radius`: a pixel is set if any ink lies within
+// `radius` in x and y. Done as two 1D passes.
+static std::vector<uint8_t> dilate(const std::vector<uint8_t>& m, int w, int h,
+                                   int radius) {
+    std::vector<uint8_t> tmp(m.size()), out(m.size());
+    for (int y = 0; y < h; ++y) {
+        int last = -1000000; // Last ink x seen, scanning left to right
+        for (int x = 0; x < w + radius; ++x) {
+            if (x < w && m[(size_t)y * w + x])
+                last = x;
+            int t = x - radius;
+            if (t >= 0 && t < w && x - last <= 2 * radius)
+                tmp[(size_t)y * w + t] = 1;
+        }
+    }
+    for (int x = 0; x < w; ++x) {
+        int last = -1000000;
+        for (int y = 0; y < h + radius; ++y) {
+            if (y < h && tmp[(size_t)y * w + x])
+                last = y;
+            int t = y - radius;
+            if (t >= 0 && t < h && y - last <= 2 * radius)
+                out[(size_t)t * w + x] = 1;
+        }
+    }
+    return out;
+}
+
+struct Score {
+    double precision = 0, recall = 0;
+    int dx = 0, dy = 0;
+};
+
+// Compares the rendered image with the reference placed at origin + (dx,
+// dy), for every offset within `search`, and keeps the best one.
+static Score compare(const Image& out, const Image& ref, const Scene& s,
+                     int tolerance, int search) {
+    std::vector<uint8_t> outInk = inkMask(out), refInk = inkMask(ref);
+    std::vector<uint8_t> refNear = dilate(refInk, ref.width, ref.height,
+                                          tolerance);
+    int outTol = (int)std::ceil(tolerance / s.scale);
+    std::vector<uint8_t> outNear = dilate(outInk, out.width, out.height,
+                                          outTol);
+
+    Score best;
+    double bestF = -1;
+    for (int dy = -search; dy <= search; ++dy) {
+        for (int dx = -search; dx <= search; ++dx) {
+            float ox = s.originX + dx, oy = s.originY + dy;
+            long long outTotal = 0, outHit = 0, refTotal = 0, refHit = 0;
+            for (int y = 0; y < out.height; ++y) {
+                int ry = (int)(oy + (y + 0.5f) * s.scale);
+                for (int x = 0; x < out.width; ++x) {
+                    if (!outInk[(size_t)y * out.width + x])
+                        continue;
+                    int rx = (int)(ox + (x + 0.5f) * s.scale);
+                    if (rx < 0 || ry < 0 || rx >= ref.width || ry >= ref.height)
+                        continue; // Cropped out of the screenshot
+                    ++outTotal;
+                    outHit += refNear[(size_t)ry * ref.width + rx];
+                }
+            }
+            // Only the part of the screenshot showing the client area.
+            int y0 = std::max(0, (int)std::ceil(oy));
+            for (int ry = y0; ry < ref.height; ++ry) {
+                int y = (int)std::floor((ry + 0.5f - oy) / s.scale);
+                if (y >= out.height)
+                    break;
+                for (int rx = 0; rx < ref.width; ++rx) {
+                    if (!refInk[(size_t)ry * ref.width + rx])
+                        continue;
+                    int x = (int)std::floor((rx + 0.5f - ox) / s.scale);
+                    if (x < 0 || x >= out.width)
+                        continue;
+                    ++refTotal;
+                    refHit += outNear[(size_t)y * out.width + x];
+                }
+            }
+            double p = outTotal ? (double)outHit / outTotal : 0;
+            double r = refTotal ? (double)refHit / refTotal : 0;
+            double f = (p + r > 0) ? 2 * p * r / (p + r) : 0;
+            if (f > bestF) {
+                bestF = f;
+                best = {p, r, dx, dy};
+            }
+        }
+    }
+    return best;
+}
+
+// Runs the program headless with the scene's input and returns the wall
+// time in milliseconds, or -1 if it failed.
+static double runScene(const std::string& binDir, const Scene& s,
+                       const std::string& outPng) {
+    std::string cmd = "\"" + binDir + "/" + s.program + "\" --headless \"" +
+                      outPng + "\" " + s.args + " > /dev/null";
+    auto t0 = std::chrono::steady_clock::now();
+    FILE* p = popen(cmd.c_str(), "w");
+    if (!p)
+        return -1;
+    fputs(s.input, p);
+    int status = pclose(p);
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - t0).count();
+    return status == 0 ? ms : -1;
+}
+
+int main(int argc, char** argv) {
+    std::string binDir = "build", keepDir;
+    int tolerance = 3;
+    double threshold = 0.9;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--bin-dir"))
+            binDir = argv[i + 1];
+        else if (!strcmp(argv[i], "--tolerance"))
+            tolerance = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--threshold"))
+            threshold = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--keep"))
+            keepDir = argv[i + 1];
+    }
+
+    int failures = 0;
+    printf("%-22s %9s %10s %8s %8s  %s\n", "scene", "time_ms", "offset",
+           "precis", "recall", "result");
+    for (const Scene& s : scenes) {
+        std::string outPng = (keepDir.empty() ? std::string("/tmp") : keepDir) +
+                             "/" + s.name + ".png";
+        double ms = runScene(binDir, s, outPng);
+        Image out, ref;
+        if (ms < 0 || !readPng(outPng, out)) {
+            printf("%-22s %9s %10s %8s %8s  FAIL (did not render)\n", s.name,
+                   "-", "-", "-", "-");
+            ++failures;
+            continue;
+        }
+        if (!s.reference) {
+            printf("%-22s %9.1f %10s %8s %8s  timed\n", s.name, ms, "-", "-",
+                   "-");
+            continue;
+        }
+        if (!readPng(s.reference, ref)) {
+            printf("%-22s %9.1f %10s %8s %8s  FAIL (no %s)\n", s.name, ms, "-",
+                   "-", "-", s.reference);
+            ++failures;
+            continue;
+        }
+        Score sc = compare(out, ref, s, tolerance, 6);
+        bool ok = sc.precision >= threshold && sc.recall >= threshold;
+        char offset[32];
+        snprintf(offset, sizeof offset, "%+d,%+d", sc.dx, sc.dy);
+        printf("%-22s %9.1f %10s %8.3f %8.3f  %s\n", s.name, ms, offset,
+               sc.precision, sc.recall, ok ? "ok" : "FAIL");
+        failures += !ok;
+    }
+    return failures ? 1 : 0;
+}
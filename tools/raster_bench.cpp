@@ -0,0 +1,605 @@
+// Headless benchmarks for the shared rasterizers, written as JSON so runs
+// can be diffed between commits. No GL or window needed:
+//   g++ -std=c++17 -O2 raster_bench.cpp -o raster_bench -pthread
+//   ./raster_bench [--quick] [--out results.json]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "../common/brush_line.h"
+#include "../common/clip_batch.h"
+#include "../common/convex_clip.h"
+#include "../common/density_raster.h"
+#include "../common/fill.h"
+#include "../common/fill_shader.h"
+#include "../common/framebuffer.h"
+#include "../common/line_kernels.h"
+#include "../common/polygon_clip.h"
+#include "../common/polygon_fill.h"
+#include "../common/ring.h"
+#include "../common/segment_grid.h"
+#include "../common/thick_line.h"
+#include "../common/tile_raster.h"
+
+// The two-branch Bresenham loop the labs used before line_kernels.h.
+template <class PlotFn>
+void referenceLine(int x1, int y1, int x2, int y2, PlotFn plot) {
+    int dx = abs(x2 - x1), dy = abs(y2 - y1);
+    int sx = (x1 < x2) ? 1 : -1;
+    int sy = (y1 < y2) ? 1 : -1;
+    int err = dx - dy;
+    for (;;) {
+        plot(x1, y1);
+        if (x1 == x2 && y1 == y2)
+            break;
+        int e2 = err << 1;
+        if (e2 > -dy) {
+            err -= dy;
+            x1 += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+// 8-way midpoint circle (d = 1 - r), as in midPointCircleAlgo.
+template <class PlotFn>
+long long midpointCircle(int cx, int cy, int r, PlotFn plot) {
+    long long n = 0;
+    int x = 0, y = r, d = 1 - r;
+    while (x <= y) {
+        plot(cx + x, cy + y);
+        plot(cx - x, cy + y);
+        plot(cx + x, cy - y);
+        plot(cx - x, cy - y);
+        plot(cx + y, cy + x);
+        plot(cx - y, cy + x);
+        plot(cx + y, cy - x);
+        plot(cx - y, cy - x);
+        n += 8;
+        if (d < 0) {
+            d += (x << 1) + 3;
+        } else {
+            d += ((x - y) << 1) + 5;
+            --y;
+        }
+        ++x;
+    }
+    return n;
+}
+
+// Pixel-at-a-time 4-neighbour fill, as floodFill4N in Mid_Exam/Que_1.cpp
+// but with an explicit stack so large sizes do not overflow.
+long long floodFill4Pixel(Framebuffer& fb, int x, int y, uint32_t fill) {
+    uint32_t old = fb.get(x, y);
+    if (old == fill)
+        return 0;
+    static std::vector<int> stack;
+    stack.assign(1, y * fb.width + x);
+    long long n = 0;
+    while (!stack.empty()) {
+        int i = stack.back();
+        stack.pop_back();
+        if (fb.pixels[i] != old)
+            continue;
+        fb.pixels[i] = fill;
+        ++n;
+        int px = i % fb.width, py = i / fb.width;
+        if (px + 1 < fb.width)
+            stack.push_back(i + 1);
+        if (px > 0)
+            stack.push_back(i - 1);
+        if (py + 1 < fb.height)
+            stack.push_back(i + fb.width);
+        if (py > 0)
+            stack.push_back(i - fb.width);
+    }
+    return n;
+}
+
+struct Segment {
+    int x1, y1, x2, y2;
+};
+
+enum LineShape { LINES_MIXED, LINES_SHALLOW, LINES_STEEP };
+
+// Lines spanning most of the framebuffer. Steep lines step a whole row per
+// pixel, so they touch a new cache line every step.
+std::vector<Segment> randomSegments(int count, int size, LineShape shape) {
+    std::mt19937 rng(12345);
+    std::vector<Segment> segs(count);
+    for (Segment& s : segs) {
+        int a = rng() % size, b = rng() % size;
+        int d = rng() % (size / 8 + 1);
+        switch (shape) {
+        case LINES_MIXED:
+            s = {a, b, (int)(rng() % size), (int)(rng() % size)};
+            break;
+        case LINES_SHALLOW:
+            s = {0, a, size - 1, std::min(size - 1, a + d)};
+            break;
+        case LINES_STEEP:
+            s = {a, 0, std::min(size - 1, a + d), size - 1};
+            break;
+        }
+    }
+    return segs;
+}
+
+struct Result {
+    std::string name, variant;
+    int size;
+    long long primitives, pixels;
+    double seconds;
+};
+
+// Runs `body` (one pass over all primitives, returning pixels written)
+// until at least minSeconds have passed, and keeps the fastest pass.
+// `setup` runs untimed before every pass.
+Result measure(const char* name, const std::string& variant, int size,
+               long long primitives, double minSeconds,
+               const std::function<long long()>& body,
+               const std::function<void()>& setup = nullptr) {
+    Result r = {name, variant, size, primitives, 0, 1e30};
+    double total = 0;
+    int passes = 0;
+    while (total < minSeconds || passes < 3) {
+        if (setup)
+            setup();
+        auto t0 = std::chrono::steady_clock::now();
+        long long pixels = body();
+        double sec = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - t0).count();
+        total += sec;
+        ++passes;
+        if (sec < r.seconds) {
+            r.seconds = sec;
+            r.pixels = pixels;
+        }
+    }
+    fprintf(stderr, "%-22s %-18s %5d  %9.1f Mpixel/s\n", name, variant.c_str(),
+            size, r.pixels / r.seconds / 1e6);
+    return r;
+}
+
+void writeJson(FILE* f, const std::vector<Result>& results) {
+    fprintf(f, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        fprintf(f,
+                "    {\"name\": \"%s\", \"variant\": \"%s\", \"size\": %d, "
+                "\"primitives\": %lld, \"pixels\": %lld, \"seconds\": %.9f, "
+                "\"pixels_per_sec\": %.1f, \"ns_per_primitive\": %.2f}%s\n",
+                r.name.c_str(), r.variant.c_str(), r.size, r.primitives,
+                r.pixels, r.seconds, r.pixels / r.seconds,
+                r.seconds * 1e9 / r.primitives,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+// Segments whose batch clip differs from liangBarsky() in the accept bit
+// or in any bit of t0 / t1 (the sign of zero included). Endpoints are
+// often put on the window's edges, where the t values are zeros.
+size_t clipMismatches(const ClipWindow& win, bool convex) {
+    const size_t count = 200000;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coord(-700.0f, 700.0f);
+    const float edges[2][2] = {{win.xmin, win.xmax}, {win.ymin, win.ymax}};
+    SegmentSoA segs;
+    for (size_t i = 0; i < count; ++i) {
+        float v[4];
+        for (int k = 0; k < 4; ++k)
+            v[k] = rng() % 8 ? coord(rng) : edges[k & 1][rng() & 1];
+        segs.push(v[0], v[1], rng() % 8 ? v[2] : v[0], v[3]);
+    }
+    ClipIntervals batch;
+    if (convex)
+        cyrusBeckBatch(segs, ConvexWindow::rectangle(win), batch);
+    else
+        liangBarskyBatch(segs, win, batch);
+    size_t bad = 0;
+    for (size_t i = 0; i < count; ++i) {
+        float t0, t1;
+        bool in = liangBarsky(segs.x0[i], segs.y0[i], segs.x1[i], segs.y1[i],
+                              win, t0, t1);
+        if (in != batch.accepted(i) ||
+            (in && (memcmp(&t0, &batch.t0[i], sizeof t0) ||
+                    memcmp(&t1, &batch.t1[i], sizeof t1))))
+            ++bad;
+    }
+    return bad;
+}
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    const char* outPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--quick"))
+            quick = true;
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc)
+            outPath = argv[++i];
+    }
+    const double minSeconds = quick ? 0.02 : 0.2;
+    std::vector<int> sizes = quick ? std::vector<int>{256, 1024}
+                                   : std::vector<int>{256, 1024, 4096};
+
+    std::vector<Result> results;
+    Framebuffer fb;
+    const uint32_t ink = packRGBA(0, 0, 0), paper = packRGBA(255, 255, 255);
+    ThreadPool singleThread(1);
+
+    for (int size : sizes) {
+        fb.resize(size, size);
+        fb.clear(paper);
+        fb.color = ink;
+        auto plot = [&](int x, int y) { fb.set(x, y, ink); };
+        int lineCount = std::max(64, 4000000 / size / (quick ? 8 : 1));
+
+        // Bresenham, standard_bresenham / lab_draw_line
+        static const char* shapeName[] = {"mixed", "shallow", "steep"};
+        for (int shape = LINES_MIXED; shape <= LINES_STEEP; ++shape) {
+            std::vector<Segment> segs =
+                randomSegments(lineCount, size, (LineShape)shape);
+            results.push_back(measure(
+                "bresenham", std::string(shapeName[shape]) + "_per_octant",
+                size, lineCount, minSeconds, [&] {
+                    long long n = 0;
+                    auto count = [&](int x, int y) {
+                        plot(x, y);
+                        ++n;
+                    };
+                    for (const Segment& s : segs)
+                        bresenhamLine(s.x1, s.y1, s.x2, s.y2, count);
+                    return n;
+                }));
+            results.push_back(measure(
+                "bresenham", std::string(shapeName[shape]) + "_two_branch",
+                size, lineCount, minSeconds, [&] {
+                    long long n = 0;
+                    auto count = [&](int x, int y) {
+                        plot(x, y);
+                        ++n;
+                    };
+                    for (const Segment& s : segs)
+                        referenceLine(s.x1, s.y1, s.x2, s.y2, count);
+                    return n;
+                }));
+        }
+
+        std::vector<Segment> segs =
+            randomSegments(lineCount, size, LINES_MIXED);
+
+        // 8-neighbour bold line, drawLine8Neighbour
+        BrushStroke brush(1, BRUSH_SQUARE);
+        results.push_back(measure("bold_line_8n", "brush_spans", size,
+                                  lineCount, minSeconds, [&] {
+            long long n = 0;
+            for (const Segment& s : segs)
+                brushLineSpans(brush, s.x1, s.y1, s.x2, s.y2,
+                               [&](int y, int xa, int xb) {
+                                   fb.fillSpan(y, xa, xb);
+                                   n += xb - xa + 1;
+                               });
+            return n;
+        }));
+
+        // Thick line, thick_bresenham
+        for (int w : {3, 15}) {
+            results.push_back(measure("thick_line", "w" + std::to_string(w),
+                                      size, lineCount, minSeconds, [&] {
+                long long n = 0;
+                for (const Segment& s : segs)
+                    thickLineSpans(s.x1, s.y1, s.x2, s.y2, w,
+                                   [&](int y, int xa, int xb) {
+                                       fb.fillSpan(y, xa, xb);
+                                       n += xb - xa + 1;
+                                   });
+                return n;
+            }));
+        }
+
+        // Midpoint circle, midPointCircleAlgo. Tiny circles are call
+        // overhead; huge ones touch a new row for most pixels.
+        std::mt19937 rng(777);
+        for (int huge = 0; huge <= 1; ++huge) {
+            int count = huge ? std::max(16, lineCount / 64) : lineCount * 8;
+            std::vector<int> cs(3 * count);
+            for (int i = 0; i < count; ++i) {
+                int r = huge ? size / 4 + (int)(rng() % (size / 4))
+                             : 1 + (int)(rng() % 6);
+                cs[3 * i] = r + (int)(rng() % (size - 2 * r));
+                cs[3 * i + 1] = r + (int)(rng() % (size - 2 * r));
+                cs[3 * i + 2] = r;
+            }
+            long long circlePixels = 0;
+            for (int i = 0; i < count; ++i)
+                circlePixels += midpointCircle(0, 0, cs[3 * i + 2],
+                                               [](int, int) {});
+            const char* tag = huge ? "huge" : "tiny";
+            results.push_back(measure("midpoint_circle",
+                                      std::string(tag) + "_serial", size, count,
+                                      minSeconds, [&] {
+                long long n = 0;
+                for (int i = 0; i < count; ++i)
+                    n += midpointCircle(cs[3 * i], cs[3 * i + 1], cs[3 * i + 2],
+                                        plot);
+                return n;
+            }));
+            // Tiled on all cores, and on the calling thread alone to show
+            // what binning costs against the serial loop.
+            TileRasterizer tiles;
+            results.push_back(measure("midpoint_circle",
+                                      std::string(tag) + "_tiled", size, count,
+                                      minSeconds, [&] {
+                for (int i = 0; i < count; ++i)
+                    tiles.circle(cs[3 * i], cs[3 * i + 1], cs[3 * i + 2], ink);
+                tiles.flush(fb);
+                return circlePixels;
+            }));
+            results.push_back(measure("midpoint_circle",
+                                      std::string(tag) + "_tiled_1t", size,
+                                      count, minSeconds, [&] {
+                for (int i = 0; i < count; ++i)
+                    tiles.circle(cs[3 * i], cs[3 * i + 1], cs[3 * i + 2], ink);
+                tiles.flush(fb, singleThread);
+                return circlePixels;
+            }));
+        }
+
+        // Flood fill of the inside of a circle outline, floodFill4N
+        auto fillScene = [&] {
+            fb.clear(paper);
+            midpointCircle(size / 2, size / 2, size / 3, plot);
+        };
+        const uint32_t fillColor = packRGBA(255, 0, 255);
+        results.push_back(measure("flood_fill", "pixel_4n", size, 1,
+                                  minSeconds, [&] {
+            return floodFill4Pixel(fb, size / 2, size / 2, fillColor);
+        }, fillScene));
+        SpanFill spanFill;
+        results.push_back(measure("flood_fill", "span", size, 1, minSeconds,
+                                  [&] {
+            return spanFill.fill(fb, size / 2, size / 2, fillColor);
+        }, fillScene));
+        // Whole empty window, the best case for long runs
+        results.push_back(measure("flood_fill", "span_full_window", size, 1,
+                                  minSeconds, [&] {
+            return spanFill.fill(fb, 0, 0, fillColor);
+        }, [&] { fb.clear(paper); }));
+        spanFill.tolerance = 8;
+        results.push_back(measure("flood_fill", "span_tolerance8", size, 1,
+                                  minSeconds, [&] {
+            return spanFill.fill(fb, size / 2, size / 2, fillColor);
+        }, fillScene));
+        spanFill.tolerance = 0;
+        // Callback paint, so runs are tracked in the visited bitset
+        results.push_back(measure("flood_fill", "span_visited", size, 1,
+                                  minSeconds, [&] {
+            return spanFill.fill(fb, size / 2, size / 2,
+                                 [&](int y, int xl, int xr) {
+                                     std::fill(fb.row(y) + xl,
+                                               fb.row(y) + xr + 1, fillColor);
+                                 });
+        }, fillScene));
+        // Fill shaders on the same region, to compare with span_visited
+        ColorRamp hue = ColorRamp::hueSweep();
+        LinearGradient linear(hue, 0, 0, size, size / 3.0f);
+        RadialGradient radial(hue, size / 2.0f, size / 2.0f, size / 3.0f);
+        const char* checker[] = {"XX..", "XX..", "..XX", "..XX"};
+        PatternShader pattern = PatternShader::bitmap(checker, 4, fillColor,
+                                                      paper);
+        results.push_back(measure("flood_fill", "span_linear", size, 1,
+                                  minSeconds, [&] {
+            return spanFill.fill(fb, size / 2, size / 2,
+                                 paintSpans(fb, linear));
+        }, fillScene));
+        results.push_back(measure("flood_fill", "span_radial", size, 1,
+                                  minSeconds, [&] {
+            return spanFill.fill(fb, size / 2, size / 2,
+                                 paintSpans(fb, radial));
+        }, fillScene));
+        results.push_back(measure("flood_fill", "span_pattern", size, 1,
+                                  minSeconds, [&] {
+            return spanFill.fill(fb, size / 2, size / 2,
+                                 paintSpans(fb, pattern));
+        }, fillScene));
+
+        // Filling a known triangle: from its vertices (edge table) versus
+        // a seed fill of its outline
+        const float tx[3] = {size * 0.5f, size * 0.1f, size * 0.9f};
+        const float ty[3] = {size * 0.9f, size * 0.1f, size * 0.3f};
+        auto triangleScene = [&] {
+            fb.clear(paper);
+            for (int i = 0; i < 3; ++i)
+                bresenhamLine((int)tx[i], (int)ty[i], (int)tx[(i + 1) % 3],
+                              (int)ty[(i + 1) % 3], plot);
+        };
+        PolygonFiller polygon;
+        results.push_back(measure("shape_fill", "triangle_edge_table", size,
+                                  1, minSeconds, [&] {
+            long long n = 0;
+            polygon.fill(tx, ty, 3, [&](int y, int xl, int xr) {
+                std::fill(fb.row(y) + xl, fb.row(y) + xr + 1, fillColor);
+                n += xr - xl + 1;
+            });
+            return n;
+        }, triangleScene));
+        results.push_back(measure("shape_fill", "triangle_seed_fill", size, 1,
+                                  minSeconds, [&] {
+            return spanFill.fill(fb, size / 2, size / 2, fillColor);
+        }, triangleScene));
+        RingFiller ring;
+        results.push_back(measure("shape_fill", "disc_spans", size, 1,
+                                  minSeconds, [&] {
+            long long n = 0;
+            ring.fill(size / 2, size / 2, 0, size / 3,
+                      [&](int y, int xl, int xr) {
+                          std::fill(fb.row(y) + xl, fb.row(y) + xr + 1,
+                                    fillColor);
+                          n += xr - xl + 1;
+                      });
+            return n;
+        }, fillScene));
+        results.push_back(measure("shape_fill", "disc_seed_fill", size, 1,
+                                  minSeconds, [&] {
+            return spanFill.fill(fb, size / 2, size / 2, fillColor);
+        }, fillScene));
+
+        // Span extension alone (the inner loop of the fill), whole rows
+        for (int simd = 0; simd <= 1; ++simd) {
+            fb.clear(paper);
+            results.push_back(measure("run_scan", simd ? "simd" : "scalar",
+                                      size, size, minSeconds, [&] {
+                long long n = 0;
+                for (int y = 0; y < size; ++y) {
+                    const uint32_t* row = fb.row(y);
+                    int end = simd ? runEnd(row, 0, size, paper, 4)
+                                   : runEndScalar(row, 0, size, paper, 4);
+                    n += end + 1;
+                }
+                return n;
+            }));
+        }
+    }
+
+    // Liang-Barsky over a million random segments in task_3's logical
+    // coordinates; "pixels" counts segments here, size is the window width.
+    {
+        const size_t count = 1000000;
+        std::mt19937 rng(99);
+        std::uniform_real_distribution<float> coord(-700.0f, 700.0f);
+        SegmentSoA segs;
+        for (size_t i = 0; i < count; ++i)
+            segs.push(coord(rng), coord(rng), coord(rng), coord(rng));
+        const ClipWindow win = {-200, -150, 250, 180};
+        ClipIntervals clipped;
+        clipped.t0.resize(count);
+        clipped.t1.resize(count);
+        results.push_back(measure("liang_barsky", "scalar", 450, count,
+                                  minSeconds, [&] {
+            for (size_t i = 0; i < count; ++i)
+                liangBarsky(segs.x0[i], segs.y0[i], segs.x1[i], segs.y1[i],
+                            win, clipped.t0[i], clipped.t1[i]);
+            return (long long)count;
+        }));
+        results.push_back(measure("liang_barsky", "batch", 450, count,
+                                  minSeconds, [&] {
+            liangBarskyBatch(segs, win, clipped);
+            return (long long)count;
+        }));
+
+        // The batches must equal the scalar clipper bit for bit
+        for (int convex = 0; convex < 2; ++convex) {
+            size_t bad = clipMismatches(win, convex);
+            if (bad) {
+                fprintf(stderr, "%s differs from liangBarsky() on %zu "
+                                "segments\n",
+                        convex ? "cyrusBeckBatch" : "liangBarskyBatch", bad);
+                return 1;
+            }
+        }
+
+        // Cyrus-Beck against the same rectangle, a rotated one and a hexagon
+        const ConvexWindow convex[3] = {
+            ConvexWindow::rectangle(win),
+            ConvexWindow::rotated(25, 15, 225, 165, 0.5f),
+            ConvexWindow::regular(25, 15, 225, 165, 6)};
+        const char* convexNames[3] = {"cyrus_beck_rect", "cyrus_beck_rotated",
+                                      "cyrus_beck_hexagon"};
+        for (int k = 0; k < 3; ++k) {
+            results.push_back(measure("liang_barsky", convexNames[k], 450,
+                                      count, minSeconds, [&] {
+                cyrusBeckBatch(segs, convex[k], clipped);
+                return (long long)count;
+            }));
+        }
+
+        // Short segments and a small window: the whole batch versus the
+        // uniform grid, which only visits the cells under the window
+        std::uniform_real_distribution<float> step(-20.0f, 20.0f);
+        SegmentSoA shortSegs;
+        for (size_t i = 0; i < count; ++i) {
+            float x = coord(rng), y = coord(rng) * 0.5f;
+            shortSegs.push(x, y, x + step(rng), y + step(rng));
+        }
+        const ClipWindow small = {-40, -30, 40, 30};
+        SegmentGrid grid(-700, -365, 700, 365, 140, 73);
+        grid.insertFrom(shortSegs);
+        ClippedSegments hits;
+        results.push_back(measure("liang_barsky", "small_window_batch", 80,
+                                  count, minSeconds, [&] {
+            liangBarskyBatch(shortSegs, small, clipped);
+            return (long long)count;
+        }));
+        results.push_back(measure("liang_barsky", "small_window_grid", 80,
+                                  count, minSeconds, [&] {
+            grid.clip(shortSegs, small, hits);
+            return (long long)count;
+        }));
+    }
+
+    // Level of detail in task_3: a million sub-pixel segments counted into a
+    // density raster and turned into one image, instead of a million GL
+    // lines; "pixels" counts segments.
+    {
+        const size_t count = 1000000;
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> x(0.0f, 1050.0f), y(0.0f, 730.0f);
+        std::vector<float> xy(2 * count);
+        for (size_t i = 0; i < count; ++i) {
+            xy[2 * i] = x(rng);
+            xy[2 * i + 1] = y(rng);
+        }
+        DensityRaster density(1050, 730);
+        results.push_back(measure("density_raster", "subpixel_segments", 1050,
+                                  count, minSeconds, [&] {
+            density.clear();
+            for (size_t i = 0; i < count; ++i)
+                density.add(xy[2 * i], xy[2 * i + 1]);
+            density.image(packRGBA(255, 0, 0));
+            return (long long)count;
+        }));
+    }
+
+    // Sutherland-Hodgman on a 10000-vertex star, against the rectangle and a
+    // hexagon; "pixels" counts input vertices.
+    {
+        const int n = 10000;
+        std::vector<float> xs(n), ys(n);
+        for (int i = 0; i < n; ++i) {
+            double a = 2 * M_PI * i / n, r = (i & 1) ? 150 : 650;
+            xs[i] = (float)(r * std::cos(a));
+            ys[i] = (float)(r * std::sin(a));
+        }
+        const ClipWindow win = {-200, -150, 250, 180};
+        const ConvexWindow hexagon = ConvexWindow::regular(25, 15, 225, 165, 6);
+        PolygonClipper clipper;
+        results.push_back(measure("polygon_clip", "rect", 450, n, minSeconds,
+                                  [&] {
+            clipper.clipPolygon(xs.data(), ys.data(), n, win);
+            return (long long)n;
+        }));
+        results.push_back(measure("polygon_clip", "hexagon", 450, n,
+                                  minSeconds, [&] {
+            clipper.clipPolygon(xs.data(), ys.data(), n, hexagon);
+            return (long long)n;
+        }));
+    }
+
+    FILE* out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "cannot write %s\n", outPath);
+        return 1;
+    }
+    writeJson(out, results);
+    if (out != stdout)
+        fclose(out);
+    return 0;
+}